@@ -1,6 +1,16 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
 #include <concepts>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stack>
 #include <type_traits>
+#include <unordered_map>
+#include <vector>
 
+#include "AStarOpenList.h"
 #include "Graph.h"
 
 namespace Virtuoso
@@ -15,6 +25,16 @@ namespace Virtuoso
             { costFn(graph, n1, n2) } -> std::convertible_to<double>;
         };
 
+        /// Cost function that reads the cost stored on the edge being relaxed: AStar() calls costFn(graph, from, edge) with the NeighborIterator
+        /// of that edge instead of costFn(graph, from, to), so graphs that keep per edge costs don't have to search for the edge.
+        /// Opted into with a nested `using reads_edge_costs = std::true_type;`, so a generic cost lambda is never taken for one
+        template<typename CostFn, typename GraphType>
+        concept EdgeCostFunction = CostFunction<CostFn, GraphType> && CostFn::reads_edge_costs::value &&
+            requires(CostFn costFn, const GraphType& graph, typename GraphType::NodeHandle from, typename GraphType::NeighborIterator edge)
+        {
+            { costFn(graph, from, edge) } -> std::convertible_to<double>;
+        };
+
         template <typename NodeIndex>
         struct TraversalInfoRecord
         {
@@ -27,41 +47,379 @@ namespace Virtuoso
         template <typename T>
         using AStarResult = std::stack<T>;
 
-        template <typename NodeHandleType>
-        struct AStarFrontierEntry
+        /// Work counters for one search, to measure how a heuristic or open list behaves on a given map
+        struct AStarStats
+        {
+            std::size_t expansions = 0;     ///< nodes taken off the open list and expanded
+            std::size_t duplicatePops = 0;  ///< stale open list entries skipped because their node was already closed
+            std::size_t heuristicCalls = 0; ///< heuristic evaluations (once per touched node thanks to the per node cache)
+            std::size_t pushes = 0;         ///< open list insertions
+
+            void reset()
+            {
+                *this = AStarStats();
+            }
+        };
+
+        /// Per node traversal bookkeeping for a DenseIndexedGraph, stored as flat parallel arrays (SoA)
+        /// Keep one of these around and pass it to every query on the same graph:
+        /// records are stamped with the generation of the query that wrote them, so a new query never has to clear the arrays
+        template <DenseIndexedGraph GraphType>
+        class DenseTraversalRecords
         {
-            NodeHandleType node;
-            double cost;
+        public:
+            using NodeHandle = typename GraphType::NodeHandle;
+            using Key = std::size_t;
+
+            /// grows the arrays to fit the graph if needed and invalidates every record from the previous query
+            void beginQuery(const GraphType& graph)
+            {
+                const std::size_t nodeCount = graph.size();
+
+                if (generations.size() < nodeCount)
+                {
+                    parents.resize(nodeCount);
+                    costs.resize(nodeCount);
+                    heuristics.resize(nodeCount);
+                    generations.resize(nodeCount, 0u);
+                    closedGenerations.resize(nodeCount, 0u);
+                }
+
+                if (++generation == 0u)
+                {
+                    // stamp counter wrapped; this is the only time we pay for a full clear
+                    std::fill(generations.begin(), generations.end(), 0u);
+                    std::fill(closedGenerations.begin(), closedGenerations.end(), 0u);
+                    generation = 1u;
+                }
+            }
+
+            inline Key key(const GraphType& graph, const NodeHandle& node)
+            {
+                return graph.index_of(node);
+            }
+
+            /// true if the node at index i was reached during the current query
+            inline bool touched(std::size_t i) const
+            {
+                return generations[i] == generation;
+            }
+
+            inline void touch(std::size_t i, const NodeHandle& parent, double cost, double heuristic)
+            {
+                generations[i] = generation;
+                parents[i] = parent;
+                costs[i] = cost;
+                heuristics[i] = heuristic;
+            }
+
+            /// closed set: a node is closed once expanded, and reopened only if a cheaper path to it turns up later
+            inline bool closed(std::size_t i) const { return closedGenerations[i] == generation; }
+            inline void close(std::size_t i) { closedGenerations[i] = generation; }
+            inline void reopen(std::size_t i) { closedGenerations[i] = 0u; }
+
+            inline NodeHandle& parent(std::size_t i) { return parents[i]; }
+            inline double& cost(std::size_t i) { return costs[i]; }
+            inline double heuristic(std::size_t i) const { return heuristics[i]; }
+
+            std::vector<NodeHandle> parents;
+            std::vector<double> costs;
+            std::vector<double> heuristics; ///< heuristic is computed once per node per query and cached here
+            std::vector<std::uint32_t> generations;
+            std::vector<std::uint32_t> closedGenerations;
+            std::uint32_t generation = 0u;
+        };
+
+        /// Per node traversal bookkeeping for graphs without dense indices, keyed by handle
+        /// Uses the same generation stamping as DenseTraversalRecords: the map is not cleared between queries,
+        /// so once the nodes a workload visits have been inserted, later queries do not allocate
+        template <Graph GraphType>
+        class MapTraversalRecords
+        {
+        public:
+            using NodeHandle = typename GraphType::NodeHandle;
+
+            struct Record
+            {
+                NodeHandle parent;
+                double cost = std::numeric_limits<double>::max();
+                double heuristic = 0.0;
+                std::uint32_t generation = 0u;
+                std::uint32_t closedGeneration = 0u;
+            };
+
+            using Key = Record*;
 
-            inline bool operator<(const AStarFrontierEntry& other) const
+            void beginQuery(const GraphType&)
             {
-                return cost < other.cost;
+                if (++generation == 0u)
+                {
+                    records.clear();
+                    generation = 1u;
+                }
+            }
+
+            /// releases the memory held for nodes touched by earlier queries
+            void clear()
+            {
+                records.clear();
+            }
+
+            inline Key key(const GraphType&, const NodeHandle& node)
+            {
+                return &records[node]; // unordered_map nodes are stable, so the pointer survives later insertions
+            }
+
+            inline bool touched(Key r) const
+            {
+                return r->generation == generation;
             }
 
-            inline bool operator>(const AStarFrontierEntry& other) const
+            inline void touch(Key r, const NodeHandle& parent, double cost, double heuristic)
             {
-                return cost > other.cost;
+                r->generation = generation;
+                r->parent = parent;
+                r->cost = cost;
+                r->heuristic = heuristic;
             }
+
+            inline bool closed(Key r) const { return r->closedGeneration == generation; }
+            inline void close(Key r) { r->closedGeneration = generation; }
+            inline void reopen(Key r) { r->closedGeneration = 0u; }
+
+            inline NodeHandle& parent(Key r) { return r->parent; }
+            inline double& cost(Key r) { return r->cost; }
+            inline double heuristic(Key r) const { return r->heuristic; }
+
+            std::unordered_map<NodeHandle, Record> records;
+            std::uint32_t generation = 0u;
+        };
+
+        /// Traversal records an AStarContext uses by default: flat arrays when the graph is dense-indexed, otherwise a hash map
+        template <Graph GraphType>
+        struct AStarTraversalRecordsFor
+        {
+            using type = MapTraversalRecords<GraphType>;
+        };
+
+        template <DenseIndexedGraph GraphType>
+        struct AStarTraversalRecordsFor<GraphType>
+        {
+            using type = DenseTraversalRecords<GraphType>;
         };
 
+        template <Graph GraphType>
+        using AStarTraversalRecords = typename AStarTraversalRecordsFor<GraphType>::type;
+
+        /// Scratch storage for repeated A* queries: open list, traversal records and path buffer
+        /// Reusing one context per thread (or per agent) means steady-state queries make no heap allocations once the buffers have grown
+        /// (with MapTraversalRecords this holds once the visited nodes have been seen by an earlier query)
+        /// OpenList picks the open list policy (see AStarOpenList.h); the default binary heap works with any graph
+        template <Graph GraphType, typename Records = AStarTraversalRecords<GraphType>, typename OpenList = BinaryHeapOpenList<GraphType> >
+        class AStarContext
+        {
+        public:
+            using NodeHandle = typename GraphType::NodeHandle;
+            using FrontierEntry = AStarFrontierEntry<NodeHandle>;
+            using TraversalRecords = Records;
+            using OpenListType = OpenList;
+
+            /// pre-grows the open list and path buffer so the first queries don't allocate either
+            void reserve(std::size_t frontierSize, std::size_t pathLength)
+            {
+                frontier.reserve(frontierSize);
+                path.reserve(pathLength);
+            }
+
+            TraversalRecords records;
+            OpenList frontier;
+            std::vector<NodeHandle> path;        ///< last solution, start to target
+            AStarStats stats;                    ///< counters for the last query
+        };
+
+        enum class AStarStatus
+        {
+            InProgress, ///< open list not exhausted yet, call step() again
+            Found,      ///< path to target found
+            NoPath      ///< open list exhausted (or invalid handles), target is unreachable
+        };
+
+        namespace detail
+        {
+            /// cost of the edge edge points at, out of from
+            template<Graph GraphType, typename CostFn>
+            double AStarEdgeCost(CostFn& costFunction, const GraphType& graph, const typename GraphType::NodeHandle& from, const typename GraphType::NeighborIterator& edge)
+            {
+                if constexpr (EdgeCostFunction<CostFn, GraphType>)
+                {
+                    return double(costFunction(graph, from, edge));
+                }
+                else
+                {
+                    return double(costFunction(graph, from, *edge));
+                }
+            }
+
+            /// resets the records and open list and seeds the search with start
+            template<Graph GraphType, typename Records, typename OpenList, typename HeuristicFn>
+            void AStarBegin(
+                Records& records,
+                OpenList& frontier,
+                const GraphType& graph,
+                const typename GraphType::NodeHandle& start,
+                const typename GraphType::NodeHandle& target,
+                HeuristicFn& heuristic,
+                AStarStats& stats
+                )
+            {
+                records.beginQuery(graph);
+                frontier.clear();
+                stats.reset();
+
+                const double startHeuristic = heuristic(graph, start, target);
+                records.touch(records.key(graph, start), start, 0.0, startHeuristic);
+                frontier.push(graph, start, startHeuristic);
+
+                ++stats.heuristicCalls;
+                ++stats.pushes;
+            }
+
+            /// A* main loop, shared by every AStar overload and by AStarQuery
+            /// Expands at most maxExpansions nodes and leaves the open list intact, so a search can be resumed by calling it again
+            /// closest receives the touched node with the lowest heuristic (the best place to head for if the search is cut short)
+            template<Graph GraphType, typename Records, typename OpenList, typename CostFn, typename HeuristicFn>
+            AStarStatus AStarExpand(
+                Records& records,
+                OpenList& frontier,
+                const GraphType& graph,
+                const typename GraphType::NodeHandle& target,
+                CostFn& costFunction,
+                HeuristicFn& heuristic,
+                std::size_t maxExpansions,
+                AStarFrontierEntry<typename GraphType::NodeHandle>& closest,
+                AStarStats& stats
+                )
+            {
+                using NodeHandle = typename GraphType::NodeHandle;
+                using NeighborIterator = typename GraphType::NeighborIterator;
+
+                std::size_t expansions = 0;
+
+                while (expansions < maxExpansions)
+                {
+                    if (frontier.empty())
+                    {
+                        return AStarStatus::NoPath;
+                    }
+
+                    NodeHandle tNode = frontier.pop().node;
+
+                    if (tNode == target)
+                    {
+                        closest = {target, 0.0};
+                        return AStarStatus::Found;
+                    }
+
+                    auto t = records.key(graph, tNode);
+
+                    if (records.closed(t))
+                    {
+                        // an older entry for a node that was already expanded through a cheaper path
+                        ++stats.duplicatePops;
+                        continue;
+                    }
+
+                    records.close(t);
+                    ++stats.expansions;
+                    ++expansions;
+
+                    const double costSoFar = records.cost(t);
+
+                    for (NeighborIterator it = graph.neighbor_begin(tNode); it != graph.neighbor_end(tNode); ++it)
+                    {
+                        NodeHandle neighbor = *it;
+                        auto n = records.key(graph, neighbor);
+
+                        double proposedCost = costSoFar + AStarEdgeCost(costFunction, graph, tNode, it);
+
+                        if (!records.touched(n))
+                        {
+                            const double h = heuristic(graph, neighbor, target);
+                            ++stats.heuristicCalls;
+
+                            records.touch(n, tNode, proposedCost, h);
+                            frontier.push(graph, neighbor, proposedCost + h);
+                            ++stats.pushes;
+
+                            if (h < closest.cost)
+                            {
+                                closest = {neighbor, h};
+                            }
+                        }
+                        else if (proposedCost < records.cost(n))
+                        {
+                            records.parent(n) = tNode;
+                            records.cost(n) = proposedCost;
+                            records.reopen(n); // only happens to closed nodes when the heuristic is inconsistent
+                            frontier.push(graph, neighbor, proposedCost + records.heuristic(n)); // decrease-key if the open list supports it
+                            ++stats.pushes;
+                        }
+                    }
+                }
+
+                return frontier.empty() ? AStarStatus::NoPath : AStarStatus::InProgress;
+            }
+
+            /// runs a complete search; returns true if target was reached and the path can be recovered from the records' parent links
+            template<Graph GraphType, typename Records, typename OpenList, typename CostFn, typename HeuristicFn>
+            bool AStarSearch(
+                Records& records,
+                OpenList& frontier,
+                const GraphType& graph,
+                const typename GraphType::NodeHandle& start,
+                const typename GraphType::NodeHandle& target,
+                CostFn& costFunction,
+                HeuristicFn& heuristic,
+                AStarStats& stats
+                )
+            {
+                AStarBegin(records, frontier, graph, start, target, heuristic, stats);
+
+                AStarFrontierEntry<typename GraphType::NodeHandle> closest = {start, std::numeric_limits<double>::max()};
+                return AStarExpand(records, frontier, graph, target, costFunction, heuristic, std::numeric_limits<std::size_t>::max(), closest, stats) == AStarStatus::Found;
+            }
+
+            /// walks parent links from target back to the start node, calling visit for each node (target first)
+            template<Graph GraphType, typename Records, typename Visitor>
+            void AStarTracePath(Records& records, const GraphType& graph, const typename GraphType::NodeHandle& target, Visitor visit)
+            {
+                using NodeHandle = typename GraphType::NodeHandle;
+
+                NodeHandle q = target;
+                visit(q);
+
+                NodeHandle p = records.parent(records.key(graph, q));
+                while (q != p)
+                {
+                    visit(p);
+                    q = p;
+                    p = records.parent(records.key(graph, q));
+                }
+            }
+        }
+
         template<Graph GraphType, CostFunction<GraphType> CostFn>
         AStarResult<typename GraphType::NodeHandle> AStar(
             const GraphType& graph,
-            typename const GraphType::NodeHandle& start,
-            typename const GraphType::NodeHandle& target,
+            const typename GraphType::NodeHandle& start,
+            const typename GraphType::NodeHandle& target,
             CostFn costFunction,
             CostFn heuristic
             )
         {
             // A* algorithm implementation
             using NodeHandle = typename GraphType::NodeHandle;
-            using NodeType = typename GraphType::NodeType;
-            using NeighborIterator = typename GraphType::NeighborIterator;
             using Solution = AStarResult<NodeHandle>;
-            using FrontierEntry = AStarFrontierEntry<NodeHandle>;
-            using OpenList = std::priority_queue<FrontierEntry, std::vector<FrontierEntry>, std::greater<FrontierEntry> >;
-            using TraversalInfo = TraversalInfoRecord<NodeHandle>;
-            using TraversalRecords = std::unordered_map<NodeHandle, TraversalInfo>;
 
             Solution solution;
 
@@ -72,66 +430,406 @@ namespace Virtuoso
             
             if (start != target)
             {
-                TraversalRecords graphTraversal;
+                MapTraversalRecords<GraphType> graphTraversal;
+                BinaryHeapOpenList<GraphType> frontier;
+                AStarStats stats;
+
+                if (detail::AStarSearch(graphTraversal, frontier, graph, start, target, costFunction, heuristic, stats))
+                {
+                    detail::AStarTracePath(graphTraversal, graph, target, [&](const NodeHandle& n) { solution.push(n); });
+                }
+            }
+            
+            return solution;
+        }
 
-                TraversalInfo startRec = {start, 0.0, heuristic(graph, start, target)};
+        /// A* over a DenseIndexedGraph using flat traversal records instead of a hash map
+        /// The records are reused between queries; pass the same DenseTraversalRecords for every query against a graph to avoid reallocating them
+        template<DenseIndexedGraph GraphType, CostFunction<GraphType> CostFn, CostFunction<GraphType> HeuristicFn>
+        AStarResult<typename GraphType::NodeHandle> AStar(
+            DenseTraversalRecords<GraphType>& records,
+            const GraphType& graph,
+            const typename GraphType::NodeHandle& start,
+            const typename GraphType::NodeHandle& target,
+            CostFn costFunction,
+            HeuristicFn heuristic
+            )
+        {
+            using NodeHandle = typename GraphType::NodeHandle;
+            using Solution = AStarResult<NodeHandle>;
 
-                graphTraversal[start] = startRec;
+            Solution solution;
 
-                OpenList frontier;
-                frontier.push({start, startRec.estimatedTotalCost});
+            if (!graph.is_valid_handle(start) || !graph.is_valid_handle(target))
+            {
+                return solution;
+            }
 
-                while (!frontier.empty())
+            if (start != target)
+            {
+                BinaryHeapOpenList<GraphType> frontier;
+                AStarStats stats;
+
+                if (detail::AStarSearch(records, frontier, graph, start, target, costFunction, heuristic, stats))
                 {
-                    NodeHandle tNode = frontier.top().node;
-                    frontier.pop();
-                    
-                    //graphTraversal[tNode].visited = true;
+                    detail::AStarTracePath(records, graph, target, [&](const NodeHandle& n) { solution.push(n); });
+                }
+            }
 
-                    if (tNode == target)
-                    {
-                        solution.push(target);
+            return solution;
+        }
 
-                        // work backwards and build the path
-                        NodeHandle q = target;
-                        while(q != graphTraversal[q].parent)
-                        {
-                            NodeHandle p = graphTraversal[q].parent;
-                            solution.push(p);
-                            q = p;
-                        }
+        /// A* reusing the open list, traversal records and path buffer held by context
+        /// Returns the path from start to target (both included) as a view into context.path, valid until the next query on the context
+        /// The view is empty if either handle is invalid or target is unreachable; start == target gives a single node path
+        template<Graph GraphType, typename Records, typename OpenList, CostFunction<GraphType> CostFn, CostFunction<GraphType> HeuristicFn>
+        std::span<const typename GraphType::NodeHandle> AStar(
+            AStarContext<GraphType, Records, OpenList>& context,
+            const GraphType& graph,
+            const typename GraphType::NodeHandle& start,
+            const typename GraphType::NodeHandle& target,
+            CostFn costFunction,
+            HeuristicFn heuristic
+            )
+        {
+            using NodeHandle = typename GraphType::NodeHandle;
+
+            context.path.clear();
+            context.stats.reset();
+
+            if (!graph.is_valid_handle(start) || !graph.is_valid_handle(target))
+            {
+                return {};
+            }
 
-                        break;
+            if (start == target)
+            {
+                context.path.push_back(start);
+            }
+            else if (detail::AStarSearch(context.records, context.frontier, graph, start, target, costFunction, heuristic, context.stats))
+            {
+                detail::AStarTracePath(context.records, graph, target, [&](const NodeHandle& n) { context.path.push_back(n); });
+                std::reverse(context.path.begin(), context.path.end());
+            }
+
+            return context.path;
+        }
+
+        /// Scratch storage for AStarBidirectional: one context per search direction
+        template <Graph GraphType, typename Records = AStarTraversalRecords<GraphType>, typename OpenList = BinaryHeapOpenList<GraphType> >
+        struct AStarBidirectionalContext
+        {
+            AStarContext<GraphType, Records, OpenList> forward;  ///< search from start; also holds the resulting path
+            AStarContext<GraphType, Records, OpenList> backward; ///< search from target
+        };
+
+        namespace detail
+        {
+            /// expands one node of one direction of a bidirectional search and records any cheaper meeting point with the other direction
+            /// reversed is true for the search that runs from target, which walks edges against their direction
+            template<Graph GraphType, typename Records, typename OpenList, typename CostFn, typename HeuristicFn>
+            void AStarBidirectionalStep(
+                AStarContext<GraphType, Records, OpenList>& self,
+                AStarContext<GraphType, Records, OpenList>& other,
+                const GraphType& graph,
+                const typename GraphType::NodeHandle& goal,
+                CostFn& costFunction,
+                HeuristicFn& heuristic,
+                bool reversed,
+                double& bestCost,
+                typename GraphType::NodeHandle& meet
+                )
+            {
+                using NodeHandle = typename GraphType::NodeHandle;
+                using NeighborIterator = typename GraphType::NeighborIterator;
+
+                Records& records = self.records;
+                OpenList& frontier = self.frontier;
+
+                NodeHandle tNode = frontier.pop().node;
+
+                auto t = records.key(graph, tNode);
+
+                if (records.closed(t))
+                {
+                    ++self.stats.duplicatePops;
+                    return;
+                }
+
+                records.close(t);
+                ++self.stats.expansions;
+
+                const double costSoFar = records.cost(t);
+
+                for (NeighborIterator it = graph.neighbor_begin(tNode); it != graph.neighbor_end(tNode); ++it)
+                {
+                    NodeHandle neighbor = *it;
+                    auto n = records.key(graph, neighbor);
+
+                    double proposedCost = costSoFar + (reversed ? costFunction(graph, neighbor, tNode) : AStarEdgeCost(costFunction, graph, tNode, it));
+
+                    if (!records.touched(n))
+                    {
+                        const double h = heuristic(graph, neighbor, goal);
+                        ++self.stats.heuristicCalls;
+
+                        records.touch(n, tNode, proposedCost, h);
+                        frontier.push(graph, neighbor, proposedCost + h);
+                    }
+                    else if (proposedCost < records.cost(n))
+                    {
+                        records.parent(n) = tNode;
+                        records.cost(n) = proposedCost;
+                        records.reopen(n);
+                        frontier.push(graph, neighbor, proposedCost + records.heuristic(n));
+                    }
+                    else
+                    {
+                        continue;
                     }
 
-                    const double& costSoFar = graphTraversal[tNode].cost;
+                    ++self.stats.pushes;
 
-                    for (NeighborIterator it = graph.neighbor_begin(tNode); it != graph.neighbor_end(tNode); ++it)
+                    auto o = other.records.key(graph, neighbor);
+
+                    if (other.records.touched(o) && proposedCost + other.records.cost(o) < bestCost)
                     {
-                        NodeHandle neighbor = *it;
+                        bestCost = proposedCost + other.records.cost(o);
+                        meet = neighbor;
+                    }
+                }
+            }
+        }
+
+        /// Bidirectional A*: searches forward from start and backward from target at the same time, always growing the smaller open list
+        /// Only valid for undirected graphs: every neighbor relation must hold both ways, since the backward search walks the same neighbor lists
+        /// (costs are still evaluated in the direction of travel). Stops as soon as either open list's best estimate can't beat the best meeting point,
+        /// which gives an optimal path when the heuristic is consistent.
+        /// Returns the path from start to target as a view into context.forward.path; counters are in context.forward.stats and context.backward.stats
+        template<Graph GraphType, typename Records, typename OpenList, CostFunction<GraphType> CostFn, CostFunction<GraphType> HeuristicFn>
+        std::span<const typename GraphType::NodeHandle> AStarBidirectional(
+            AStarBidirectionalContext<GraphType, Records, OpenList>& context,
+            const GraphType& graph,
+            const typename GraphType::NodeHandle& start,
+            const typename GraphType::NodeHandle& target,
+            CostFn costFunction,
+            HeuristicFn heuristic
+            )
+        {
+            using NodeHandle = typename GraphType::NodeHandle;
+
+            AStarContext<GraphType, Records, OpenList>& forward = context.forward;
+            AStarContext<GraphType, Records, OpenList>& backward = context.backward;
 
-                        const TraversalInfo& traversalInfo = graphTraversal[neighbor];
+            forward.path.clear();
+            forward.stats.reset();
+            backward.stats.reset();
 
-                        double proposedCost = costSoFar + costFunction(graph, tNode, neighbor);
+            if (!graph.is_valid_handle(start) || !graph.is_valid_handle(target))
+            {
+                return {};
+            }
 
-                        TraversalInfo info;
-                        info.parent = tNode;
-                        info.cost = proposedCost;
-                        info.estimatedTotalCost = info.cost + heuristic(graph, neighbor, target);   ///\todo cache heuristic cost instead of recalculating
-                        //info.visited = false;
+            if (start == target)
+            {
+                forward.path.push_back(start);
+                return forward.path;
+            }
 
-                        bool newPathBetter = proposedCost < traversalInfo.cost;
+            detail::AStarBegin(forward.records, forward.frontier, graph, start, target, heuristic, forward.stats);
+            detail::AStarBegin(backward.records, backward.frontier, graph, target, start, heuristic, backward.stats);
 
-                        if (newPathBetter)
-                        {
-                            graphTraversal[neighbor] = info;
-                            frontier.push({neighbor, info.estimatedTotalCost});
-                        }
-                    }       
+            double bestCost = std::numeric_limits<double>::max();
+            NodeHandle meet = start;
+
+            while (!forward.frontier.empty() && !backward.frontier.empty())
+            {
+                if (forward.frontier.top().cost >= bestCost || backward.frontier.top().cost >= bestCost)
+                {
+                    break;
+                }
+
+                if (forward.frontier.size() <= backward.frontier.size())
+                {
+                    detail::AStarBidirectionalStep(forward, backward, graph, target, costFunction, heuristic, false, bestCost, meet);
+                }
+                else
+                {
+                    detail::AStarBidirectionalStep(backward, forward, graph, start, costFunction, heuristic, true, bestCost, meet);
                 }
             }
-            
-            return solution;
+
+            if (bestCost == std::numeric_limits<double>::max())
+            {
+                return {};
+            }
+
+            detail::AStarTracePath(forward.records, graph, meet, [&](const NodeHandle& n) { forward.path.push_back(n); });
+            std::reverse(forward.path.begin(), forward.path.end());
+
+            bool first = true;
+            detail::AStarTracePath(backward.records, graph, meet, [&](const NodeHandle& n)
+            {
+                if (!first)
+                {
+                    forward.path.push_back(n);
+                }
+
+                first = false;
+            });
+
+            return forward.path;
         }
+
+        /// Resumable A* query for spreading long searches over several frames
+        /// Call begin() once, then step() with an expansion count or a deadline until it stops returning InProgress.
+        /// The open list and traversal records live in the query between calls, so keep one query object per in-flight search.
+        /// While the search is still running, partialPath() gives the path to the closest node (lowest heuristic) reached so far,
+        /// so an agent can start moving before the full path is known
+        template<Graph GraphType, CostFunction<GraphType> CostFn, CostFunction<GraphType> HeuristicFn,
+            typename Records = AStarTraversalRecords<GraphType>, typename OpenList = BinaryHeapOpenList<GraphType> >
+        class AStarQuery
+        {
+        public:
+            using NodeHandle = typename GraphType::NodeHandle;
+            using Clock = std::chrono::steady_clock;
+
+            AStarQuery(const GraphType& graph, CostFn costFunction, HeuristicFn heuristic)
+                : graph(&graph), costFunction(costFunction), heuristic(heuristic)
+            {
+            }
+
+            /// starts a new search, discarding any search in progress; storage from earlier searches is reused
+            void begin(const NodeHandle& start, const NodeHandle& target)
+            {
+                this->start = start;
+                this->target = target;
+                context.path.clear();
+                context.frontier.clear();
+                context.stats.reset();
+                seeded = false;
+
+                if (!graph->is_valid_handle(start) || !graph->is_valid_handle(target))
+                {
+                    currentStatus = AStarStatus::NoPath;
+                    return;
+                }
+
+                detail::AStarBegin(context.records, context.frontier, *graph, start, target, heuristic, context.stats);
+                closest = {start, context.records.heuristic(context.records.key(*graph, start))};
+                seeded = true;
+                currentStatus = (start == target) ? AStarStatus::Found : AStarStatus::InProgress;
+            }
+
+            /// expands at most maxExpansions nodes
+            AStarStatus step(std::size_t maxExpansions)
+            {
+                if (currentStatus == AStarStatus::InProgress)
+                {
+                    currentStatus = detail::AStarExpand(context.records, context.frontier, *graph, target, costFunction, heuristic, maxExpansions, closest, context.stats);
+                }
+
+                return currentStatus;
+            }
+
+            /// expands nodes until the search finishes or the deadline passes
+            /// the clock is only read every deadlineCheckInterval expansions, so the deadline can be overrun by that many expansions
+            AStarStatus step(Clock::time_point deadline)
+            {
+                while (currentStatus == AStarStatus::InProgress && Clock::now() < deadline)
+                {
+                    step(deadlineCheckInterval);
+                }
+
+                return currentStatus;
+            }
+
+            /// runs the search to completion
+            AStarStatus finish()
+            {
+                return step(std::numeric_limits<std::size_t>::max());
+            }
+
+            AStarStatus status() const
+            {
+                return currentStatus;
+            }
+
+            /// path from start to target once status() is Found, empty otherwise
+            /// the view is valid until the next call to path(), partialPath() or begin()
+            std::span<const NodeHandle> path()
+            {
+                if (currentStatus != AStarStatus::Found)
+                {
+                    context.path.clear();
+                    return {};
+                }
+
+                return tracePath(target);
+            }
+
+            /// path from start to the touched node closest to target so far (the full path once Found)
+            /// the view is valid until the next call to path(), partialPath() or begin()
+            std::span<const NodeHandle> partialPath()
+            {
+                if (currentStatus == AStarStatus::Found)
+                {
+                    return tracePath(target);
+                }
+
+                if (!seeded)
+                {
+                    context.path.clear();
+                    return {};
+                }
+
+                return tracePath(closest.node);
+            }
+
+            /// counters accumulated over every step() of the current search
+            const AStarStats& stats() const
+            {
+                return context.stats;
+            }
+
+            /// node closest to target (by heuristic) reached so far
+            const NodeHandle& closestNode() const
+            {
+                return closest.node;
+            }
+
+            /// number of expansions between clock reads in step(deadline)
+            std::size_t deadlineCheckInterval = 64;
+
+        private:
+
+            std::span<const NodeHandle> tracePath(const NodeHandle& end)
+            {
+                context.path.clear();
+
+                if (start == end)
+                {
+                    context.path.push_back(start);
+                }
+                else
+                {
+                    detail::AStarTracePath(context.records, *graph, end, [&](const NodeHandle& n) { context.path.push_back(n); });
+                    std::reverse(context.path.begin(), context.path.end());
+                }
+
+                return context.path;
+            }
+
+            const GraphType* graph;
+            CostFn costFunction;
+            HeuristicFn heuristic;
+
+            AStarContext<GraphType, Records, OpenList> context;
+            NodeHandle start{};
+            NodeHandle target{};
+            AStarFrontierEntry<NodeHandle> closest{};
+            AStarStatus currentStatus = AStarStatus::NoPath;
+            bool seeded = false;
+        };
     }
 }
\ No newline at end of file
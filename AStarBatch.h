@@ -0,0 +1,268 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "AStar.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        template <typename NodeHandle>
+        struct AStarPathRequest
+        {
+            NodeHandle start;
+            NodeHandle target;
+        };
+
+        template <typename NodeHandle>
+        struct AStarPathResult
+        {
+            std::vector<NodeHandle> path; ///< start to target, empty if no path; capacity is kept between batches
+            AStarStatus status = AStarStatus::NoPath;
+        };
+
+        /// Fixed pool of worker threads for running many independent A* queries against one read-only graph
+        /// Every worker owns an AStarContext, so queries don't share scratch state or allocate once the contexts have warmed up.
+        /// A batch is split into one contiguous index range per worker; a worker that runs dry steals half of another worker's remaining range.
+        /// The thread calling run() works as worker 0, so a pool of N workers starts N - 1 threads.
+        /// Graph access is const only, but the cost and heuristic functions are called concurrently and must be safe to call from several threads
+        template <Graph GraphType, typename Records = AStarTraversalRecords<GraphType>, typename OpenList = BinaryHeapOpenList<GraphType> >
+        class AStarBatchPool
+        {
+        public:
+            using NodeHandle = typename GraphType::NodeHandle;
+            using Request = AStarPathRequest<NodeHandle>;
+            using Result = AStarPathResult<NodeHandle>;
+
+            explicit AStarBatchPool(std::size_t workerCount = std::thread::hardware_concurrency())
+                : workerCount(std::max<std::size_t>(workerCount, 1u)), workers(new Worker[this->workerCount])
+            {
+                threads.reserve(this->workerCount - 1);
+
+                for (std::size_t i = 1; i < this->workerCount; ++i)
+                {
+                    threads.emplace_back([this, i]() { threadMain(i); });
+                }
+            }
+
+            ~AStarBatchPool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopping = true;
+                }
+
+                wake.notify_all();
+
+                for (std::thread& t : threads)
+                {
+                    t.join();
+                }
+            }
+
+            AStarBatchPool(const AStarBatchPool&) = delete;
+            AStarBatchPool& operator=(const AStarBatchPool&) = delete;
+
+            std::size_t size() const
+            {
+                return workerCount;
+            }
+
+            /// runs requests[i] and writes the outcome into results[i]; blocks until the whole batch is done
+            /// results must have at least as many slots as requests
+            template<CostFunction<GraphType> CostFn, CostFunction<GraphType> HeuristicFn>
+            void run(const GraphType& graph, std::span<const Request> requests, std::span<Result> results, CostFn costFunction, HeuristicFn heuristic)
+            {
+                assert(results.size() >= requests.size());
+
+                if (requests.empty())
+                {
+                    return;
+                }
+
+                struct Job
+                {
+                    const GraphType& graph;
+                    std::span<const Request> requests;
+                    std::span<Result> results;
+                    CostFn& costFunction;
+                    HeuristicFn& heuristic;
+
+                    static void execute(void* self, AStarContext<GraphType, Records, OpenList>& context, std::size_t i)
+                    {
+                        Job& job = *static_cast<Job*>(self);
+                        const Request& request = job.requests[i];
+                        Result& result = job.results[i];
+
+                        std::span<const NodeHandle> path = AStar(context, job.graph, request.start, request.target, job.costFunction, job.heuristic);
+                        result.path.assign(path.begin(), path.end());
+                        result.status = path.empty() ? AStarStatus::NoPath : AStarStatus::Found;
+                    }
+                };
+
+                Job job{graph, requests, results, costFunction, heuristic};
+
+                // hand out equal contiguous ranges up front; stealing evens out queries of different lengths
+                const std::size_t count = requests.size();
+                for (std::size_t w = 0; w < workerCount; ++w)
+                {
+                    const std::uint32_t begin = std::uint32_t(count * w / workerCount);
+                    const std::uint32_t end = std::uint32_t(count * (w + 1) / workerCount);
+                    workers[w].range.store(packRange(begin, end), std::memory_order_relaxed);
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    currentJob = &job;
+                    currentExecute = &Job::execute;
+                    busyWorkers = workerCount - 1;
+                    ++batch;
+                }
+
+                wake.notify_all();
+
+                work(0, &job, &Job::execute);
+
+                std::unique_lock<std::mutex> lock(mutex);
+                done.wait(lock, [this]() { return busyWorkers == 0; });
+                currentJob = nullptr;
+            }
+
+        private:
+
+            using ExecuteFn = void (*)(void*, AStarContext<GraphType, Records, OpenList>&, std::size_t);
+
+            /// remaining request indices [begin, end) of one worker, packed so owner and thieves can update it with a single CAS
+            static std::uint64_t packRange(std::uint32_t begin, std::uint32_t end)
+            {
+                return (std::uint64_t(end) << 32) | begin;
+            }
+
+            static std::uint32_t rangeBegin(std::uint64_t r) { return std::uint32_t(r); }
+            static std::uint32_t rangeEnd(std::uint64_t r) { return std::uint32_t(r >> 32); }
+
+            struct alignas(64) Worker
+            {
+                std::atomic<std::uint64_t> range{0};
+                AStarContext<GraphType, Records, OpenList> context;
+            };
+
+            /// takes the next index off the front of the worker's own range
+            bool popOwn(Worker& self, std::size_t& index)
+            {
+                std::uint64_t r = self.range.load(std::memory_order_acquire);
+
+                while (rangeBegin(r) < rangeEnd(r))
+                {
+                    if (self.range.compare_exchange_weak(r, packRange(rangeBegin(r) + 1, rangeEnd(r)), std::memory_order_acq_rel))
+                    {
+                        index = rangeBegin(r);
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            /// moves the back half of another worker's range into self; only called while self's range is empty
+            bool steal(std::size_t thief)
+            {
+                for (std::size_t offset = 1; offset < workerCount; ++offset)
+                {
+                    Worker& victim = workers[(thief + offset) % workerCount];
+                    std::uint64_t r = victim.range.load(std::memory_order_acquire);
+
+                    while (rangeBegin(r) < rangeEnd(r))
+                    {
+                        const std::uint32_t begin = rangeBegin(r);
+                        const std::uint32_t end = rangeEnd(r);
+                        const std::uint32_t mid = begin + (end - begin) / 2;
+
+                        if (victim.range.compare_exchange_weak(r, packRange(begin, mid), std::memory_order_acq_rel))
+                        {
+                            workers[thief].range.store(packRange(mid, end), std::memory_order_release);
+                            return true;
+                        }
+                    }
+                }
+
+                return false;
+            }
+
+            void work(std::size_t w, void* job, ExecuteFn execute)
+            {
+                Worker& self = workers[w];
+                std::size_t index;
+
+                do
+                {
+                    while (popOwn(self, index))
+                    {
+                        execute(job, self.context, index);
+                    }
+                }
+                while (steal(w));
+            }
+
+            void threadMain(std::size_t w)
+            {
+                std::uint64_t seenBatch = 0;
+
+                for (;;)
+                {
+                    void* job;
+                    ExecuteFn execute;
+
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        wake.wait(lock, [&]() { return stopping || batch != seenBatch; });
+
+                        if (stopping)
+                        {
+                            return;
+                        }
+
+                        seenBatch = batch;
+                        job = currentJob;
+                        execute = currentExecute;
+                    }
+
+                    work(w, job, execute);
+
+                    bool last;
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        last = (--busyWorkers == 0);
+                    }
+
+                    if (last)
+                    {
+                        done.notify_one();
+                    }
+                }
+            }
+
+            std::size_t workerCount;
+            std::unique_ptr<Worker[]> workers;
+            std::vector<std::thread> threads;
+
+            std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable done;
+            void* currentJob = nullptr;
+            ExecuteFn currentExecute = nullptr;
+            std::uint64_t batch = 0;
+            std::size_t busyWorkers = 0;
+            bool stopping = false;
+        };
+    }
+}
@@ -0,0 +1,334 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "Graph.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        template <typename NodeHandleType>
+        struct AStarFrontierEntry
+        {
+            NodeHandleType node;
+            double cost;
+
+            inline bool operator<(const AStarFrontierEntry& other) const
+            {
+                return cost < other.cost;
+            }
+
+            inline bool operator>(const AStarFrontierEntry& other) const
+            {
+                return cost > other.cost;
+            }
+        };
+
+        /// Open list policies for AStarContext. Each one provides:
+        ///     clear(), empty(), size(), reserve(n),
+        ///     push(graph, node, priority)  - insert, or lower the priority of a node already queued (policies without decrease-key just add another entry),
+        ///     top()                        - lowest priority entry,
+        ///     pop()                        - remove and return the lowest priority entry
+
+        /// Binary min-heap on a vector (std::push_heap / std::pop_heap), no decrease-key: an improved path pushes a second entry for the node
+        /// and the search's closed set skips the stale one when it comes out. Works with any graph
+        template <Graph GraphType>
+        class BinaryHeapOpenList
+        {
+        public:
+            using NodeHandle = typename GraphType::NodeHandle;
+            using FrontierEntry = AStarFrontierEntry<NodeHandle>;
+
+            void clear() { heap.clear(); }
+            bool empty() const { return heap.empty(); }
+            std::size_t size() const { return heap.size(); }
+            void reserve(std::size_t n) { heap.reserve(n); }
+
+            void push(const GraphType&, const NodeHandle& node, double priority)
+            {
+                heap.push_back({node, priority});
+                std::push_heap(heap.begin(), heap.end(), std::greater<FrontierEntry>());
+            }
+
+            const FrontierEntry& top() const
+            {
+                return heap.front();
+            }
+
+            FrontierEntry pop()
+            {
+                std::pop_heap(heap.begin(), heap.end(), std::greater<FrontierEntry>());
+                FrontierEntry e = heap.back();
+                heap.pop_back();
+                return e;
+            }
+
+        private:
+            std::vector<FrontierEntry> heap;
+        };
+
+        /// Indexed d-ary min-heap with decrease-key (4-ary by default) for DenseIndexedGraph
+        /// Every node is in the heap at most once, so the heap never grows past the true frontier.
+        /// A wider node shortens the tree, and the children of a node sit next to each other in memory
+        template <DenseIndexedGraph GraphType, std::size_t Arity = 4>
+        class IndexedDaryHeapOpenList
+        {
+        public:
+            using NodeHandle = typename GraphType::NodeHandle;
+            using FrontierEntry = AStarFrontierEntry<NodeHandle>;
+
+            static_assert(Arity >= 2, "heap arity must be at least 2");
+
+            void clear()
+            {
+                for (const Slot& slot : heap)
+                {
+                    positions[slot.index] = notQueued;
+                }
+
+                heap.clear();
+            }
+
+            bool empty() const { return heap.empty(); }
+            std::size_t size() const { return heap.size(); }
+            void reserve(std::size_t n) { heap.reserve(n); }
+
+            void push(const GraphType& graph, const NodeHandle& node, double priority)
+            {
+                const std::size_t index = graph.index_of(node);
+
+                if (index >= positions.size())
+                {
+                    positions.resize(std::max<std::size_t>(graph.size(), index + 1), notQueued);
+                }
+
+                const std::uint32_t position = positions[index];
+
+                if (position != notQueued)
+                {
+                    if (priority < heap[position].entry.cost)
+                    {
+                        heap[position].entry.cost = priority;
+                        siftUp(position);
+                    }
+
+                    return;
+                }
+
+                heap.push_back({{node, priority}, std::uint32_t(index)});
+                positions[index] = std::uint32_t(heap.size() - 1);
+                siftUp(heap.size() - 1);
+            }
+
+            const FrontierEntry& top() const
+            {
+                return heap.front().entry;
+            }
+
+            FrontierEntry pop()
+            {
+                const FrontierEntry e = heap.front().entry;
+                positions[heap.front().index] = notQueued;
+
+                if (heap.size() > 1)
+                {
+                    heap.front() = heap.back();
+                    positions[heap.front().index] = 0;
+                    heap.pop_back();
+                    siftDown(0);
+                }
+                else
+                {
+                    heap.pop_back();
+                }
+
+                return e;
+            }
+
+        private:
+
+            static constexpr std::uint32_t notQueued = std::numeric_limits<std::uint32_t>::max();
+
+            struct Slot
+            {
+                FrontierEntry entry;
+                std::uint32_t index; ///< graph.index_of(entry.node), kept so positions can be updated without the graph
+            };
+
+            void place(std::size_t position, const Slot& slot)
+            {
+                heap[position] = slot;
+                positions[slot.index] = std::uint32_t(position);
+            }
+
+            void siftUp(std::size_t position)
+            {
+                const Slot slot = heap[position];
+
+                while (position > 0)
+                {
+                    const std::size_t parent = (position - 1) / Arity;
+
+                    if (!(slot.entry.cost < heap[parent].entry.cost))
+                    {
+                        break;
+                    }
+
+                    place(position, heap[parent]);
+                    position = parent;
+                }
+
+                place(position, slot);
+            }
+
+            void siftDown(std::size_t position)
+            {
+                const Slot slot = heap[position];
+                const std::size_t count = heap.size();
+
+                for (;;)
+                {
+                    const std::size_t firstChild = position * Arity + 1;
+
+                    if (firstChild >= count)
+                    {
+                        break;
+                    }
+
+                    const std::size_t lastChild = std::min(firstChild + Arity, count);
+                    std::size_t best = firstChild;
+
+                    for (std::size_t c = firstChild + 1; c < lastChild; ++c)
+                    {
+                        if (heap[c].entry.cost < heap[best].entry.cost)
+                        {
+                            best = c;
+                        }
+                    }
+
+                    if (!(heap[best].entry.cost < slot.entry.cost))
+                    {
+                        break;
+                    }
+
+                    place(position, heap[best]);
+                    position = best;
+                }
+
+                place(position, slot);
+            }
+
+            std::vector<Slot> heap;
+            std::vector<std::uint32_t> positions; ///< heap position per node index, notQueued if the node isn't in the heap
+        };
+
+        /// Radix heap for graphs with integer costs and heuristics
+        /// Priorities are turned into integer keys (floor(priority * keyScale)) and spread over 65 buckets by the highest bit in which
+        /// they differ from the last key popped, so push is O(1) and pop is amortized O(log C).
+        /// Keys must never drop below the last key popped, which holds for A* when the heuristic is consistent.
+        /// Entries with the same key come out in no particular order; with non integer costs, a keyScale > 1 keeps that error below 1 / keyScale.
+        /// No decrease-key: improved paths add a second entry, as with BinaryHeapOpenList
+        template <Graph GraphType>
+        class RadixHeapOpenList
+        {
+        public:
+            using NodeHandle = typename GraphType::NodeHandle;
+            using FrontierEntry = AStarFrontierEntry<NodeHandle>;
+
+            explicit RadixHeapOpenList(double keyScale = 1.0) : keyScale(keyScale)
+            {
+            }
+
+            void clear()
+            {
+                for (auto& bucket : buckets)
+                {
+                    bucket.clear();
+                }
+
+                count = 0;
+                last = 0;
+            }
+
+            bool empty() const { return count == 0; }
+            std::size_t size() const { return count; }
+            void reserve(std::size_t n) { buckets[0].reserve(n); }
+
+            void push(const GraphType&, const NodeHandle& node, double priority)
+            {
+                const std::uint64_t key = std::uint64_t(std::max(priority, 0.0) * keyScale);
+                assert(key >= last && "radix heap keys must not decrease (is the heuristic consistent?)");
+
+                buckets[bucketOf(std::max(key, last))].push_back({{node, priority}, key});
+                ++count;
+            }
+
+            const FrontierEntry& top()
+            {
+                refill();
+                return buckets[0].back().entry;
+            }
+
+            FrontierEntry pop()
+            {
+                refill();
+                const FrontierEntry e = buckets[0].back().entry;
+                buckets[0].pop_back();
+                --count;
+                return e;
+            }
+
+        private:
+
+            struct Slot
+            {
+                FrontierEntry entry;
+                std::uint64_t key;
+            };
+
+            std::size_t bucketOf(std::uint64_t key) const
+            {
+                return key == last ? 0 : std::size_t(64 - std::countl_zero(key ^ last));
+            }
+
+            /// when bucket 0 runs dry, moves the smallest key of the first non empty bucket into last and redistributes that bucket
+            void refill()
+            {
+                assert(count > 0);
+
+                if (!buckets[0].empty())
+                {
+                    return;
+                }
+
+                std::size_t i = 1;
+                while (buckets[i].empty())
+                {
+                    ++i;
+                }
+
+                std::vector<Slot>& source = buckets[i];
+                last = std::min_element(source.begin(), source.end(), [](const Slot& a, const Slot& b) { return a.key < b.key; })->key;
+
+                for (const Slot& slot : source)
+                {
+                    buckets[bucketOf(slot.key)].push_back(slot);
+                }
+
+                source.clear();
+            }
+
+            std::array<std::vector<Slot>, 65> buckets;
+            std::size_t count = 0;
+            std::uint64_t last = 0;
+            double keyScale;
+        };
+    }
+}
@@ -0,0 +1,350 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Graph.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// Directed edge for building a CSR graph from an edge list
+        template <typename IndexType = std::uint32_t, typename EdgeCostType = float>
+        struct CSREdge
+        {
+            IndexType from;
+            IndexType to;
+            EdgeCostType cost = EdgeCostType(1);
+        };
+
+        /// Bytes used by each array of a CSR graph
+        struct CSRGraphFootprint
+        {
+            std::size_t nodeBytes = 0;
+            std::size_t offsetBytes = 0;
+            std::size_t neighborBytes = 0;
+            std::size_t edgeCostBytes = 0;
+
+            std::size_t total() const
+            {
+                return nodeBytes + offsetBytes + neighborBytes + edgeCostBytes;
+            }
+        };
+
+        /// Read only compressed sparse row graph over arrays owned by someone else (a CSRGraph, a mapped file, ...)
+        /// The neighbors of node n are neighbors[offsets[n]] .. neighbors[offsets[n + 1]], so a node's edges sit next to each other in memory
+        /// and NeighborIterator is a plain pointer. edgeCosts is either null or parallel to neighbors.
+        /// Satisfies DenseIndexedGraph: handles are the node indices themselves
+        template <typename NodeT, typename IndexType = std::uint32_t, typename EdgeCostType = float>
+        class CSRGraphView
+        {
+        public:
+            using NodeType = NodeT;
+            using NodeHandle = IndexType;
+            using NeighborIterator = const IndexType*;
+            using EdgeCost = EdgeCostType;
+
+            CSRGraphView() = default;
+
+            /// offsets has nodeCount + 1 entries, offsets[nodeCount] being the edge count
+            CSRGraphView(const NodeType* nodes, std::size_t nodeCount, const IndexType* offsets, const IndexType* neighbors, const EdgeCostType* edgeCosts = nullptr)
+                : nodes(nodes), nodeCount(nodeCount), offsets(offsets), neighbors(neighbors), edgeCosts(edgeCosts)
+            {
+            }
+
+            // Graph interface
+
+            const NodeType& operator[](NodeHandle node) const
+            {
+                return nodes[node];
+            }
+
+            NeighborIterator neighbor_begin(NodeHandle node) const
+            {
+                return neighbors + offsets[node];
+            }
+
+            NeighborIterator neighbor_end(NodeHandle node) const
+            {
+                return neighbors + offsets[node + 1];
+            }
+
+            size_t size() const
+            {
+                return nodeCount;
+            }
+
+            bool is_valid_handle(NodeHandle node) const
+            {
+                return std::size_t(node) < nodeCount;
+            }
+
+            std::size_t index_of(NodeHandle node) const
+            {
+                return node;
+            }
+
+            // CSR specific
+
+            std::size_t edge_count() const
+            {
+                return nodeCount ? std::size_t(offsets[nodeCount]) : 0;
+            }
+
+            std::size_t degree(NodeHandle node) const
+            {
+                return std::size_t(offsets[node + 1] - offsets[node]);
+            }
+
+            std::span<const IndexType> neighbors_of(NodeHandle node) const
+            {
+                return {neighbor_begin(node), neighbor_end(node)};
+            }
+
+            bool has_edge_costs() const
+            {
+                return edgeCosts != nullptr;
+            }
+
+            /// cost of the edge an iterator from neighbor_begin(from) points at; 1 if the graph has no cost array
+            EdgeCostType edge_cost(NeighborIterator edge) const
+            {
+                return edgeCosts ? edgeCosts[edge - neighbors] : EdgeCostType(1);
+            }
+
+            /// cost of the edge from -> to, found by scanning the (short) edge row of from; infinity if there is no such edge
+            double edge_cost(NodeHandle from, NodeHandle to) const
+            {
+                for (NeighborIterator it = neighbor_begin(from); it != neighbor_end(from); ++it)
+                {
+                    if (*it == to)
+                    {
+                        return double(edge_cost(it));
+                    }
+                }
+
+                return std::numeric_limits<double>::infinity();
+            }
+
+            CSRGraphFootprint footprint() const
+            {
+                CSRGraphFootprint f;
+                f.nodeBytes = nodeCount * sizeof(NodeType);
+                f.offsetBytes = (nodeCount + 1) * sizeof(IndexType);
+                f.neighborBytes = edge_count() * sizeof(IndexType);
+                f.edgeCostBytes = edgeCosts ? edge_count() * sizeof(EdgeCostType) : 0;
+                return f;
+            }
+
+            const NodeType* node_data() const { return nodes; }
+            const IndexType* offset_data() const { return offsets; }
+            const IndexType* neighbor_data() const { return neighbors; }
+            const EdgeCostType* edge_cost_data() const { return edgeCosts; }
+
+        private:
+            const NodeType* nodes = nullptr;
+            std::size_t nodeCount = 0;
+            const IndexType* offsets = nullptr;
+            const IndexType* neighbors = nullptr;
+            const EdgeCostType* edgeCosts = nullptr;
+        };
+
+        /// Compressed sparse row graph that owns its arrays
+        /// Build it once from an edge list with build(); the layout is immutable afterwards (node payloads can still be edited in place)
+        template <typename NodeT, typename IndexType = std::uint32_t, typename EdgeCostType = float>
+        class CSRGraph
+        {
+        public:
+            using View = CSRGraphView<NodeT, IndexType, EdgeCostType>;
+            using NodeType = NodeT;
+            using NodeHandle = IndexType;
+            using NeighborIterator = typename View::NeighborIterator;
+            using EdgeCost = EdgeCostType;
+            using Edge = CSREdge<IndexType, EdgeCostType>;
+
+            CSRGraph() : offsets(1, IndexType(0))
+            {
+            }
+
+            /// see build()
+            CSRGraph(std::vector<NodeType> nodes, std::span<const Edge> edges, bool storeEdgeCosts = true)
+            {
+                build(std::move(nodes), edges, storeEdgeCosts);
+            }
+
+            /// Replaces the graph with one node per entry of nodes and the given directed edges (add both directions for an undirected edge)
+            /// Edges keep their relative order within a node's row. With storeEdgeCosts false the costs in edges are ignored and every edge costs 1
+            void build(std::vector<NodeType> nodes, std::span<const Edge> edges, bool storeEdgeCosts = true)
+            {
+                assert(nodes.size() < std::size_t(std::numeric_limits<IndexType>::max()) && "too many nodes for the index type");
+                assert(edges.size() <= std::size_t(std::numeric_limits<IndexType>::max()) && "too many edges for the index type");
+
+                this->nodes = std::move(nodes);
+                const std::size_t nodeCount = this->nodes.size();
+
+                // counting sort of the edges by source node
+                offsets.assign(nodeCount + 1, IndexType(0));
+
+                for (const Edge& e : edges)
+                {
+                    assert(std::size_t(e.from) < nodeCount && std::size_t(e.to) < nodeCount && "edge endpoint out of range");
+                    ++offsets[e.from + 1];
+                }
+
+                for (std::size_t i = 0; i < nodeCount; ++i)
+                {
+                    offsets[i + 1] += offsets[i];
+                }
+
+                neighbors.resize(edges.size());
+                edgeCosts.clear();
+
+                if (storeEdgeCosts)
+                {
+                    edgeCosts.resize(edges.size());
+                }
+
+                std::vector<IndexType> cursor(offsets.begin(), offsets.end() - 1);
+
+                for (const Edge& e : edges)
+                {
+                    const IndexType slot = cursor[e.from]++;
+                    neighbors[slot] = e.to;
+
+                    if (storeEdgeCosts)
+                    {
+                        edgeCosts[slot] = e.cost;
+                    }
+                }
+            }
+
+            /// builds from any Graph, copying node payloads and walking every neighbor list once
+            /// handles lists the source nodes in the order they get their dense index, indexOf maps a source handle back to that index, and costFunction(source, a, b) gives the edge costs
+            template <Graph SourceGraph, typename IndexOfFn, typename CostFn>
+            static CSRGraph fromGraph(const SourceGraph& source, std::span<const typename SourceGraph::NodeHandle> handles, IndexOfFn indexOf, CostFn costFunction)
+            {
+                std::vector<NodeType> nodes;
+                std::vector<Edge> edges;
+                nodes.reserve(handles.size());
+
+                for (std::size_t i = 0; i < handles.size(); ++i)
+                {
+                    const auto& h = handles[i];
+                    nodes.push_back(NodeType(source[h]));
+
+                    for (auto it = source.neighbor_begin(h); it != source.neighbor_end(h); ++it)
+                    {
+                        edges.push_back({IndexType(i), IndexType(indexOf(*it)), EdgeCostType(costFunction(source, h, *it))});
+                    }
+                }
+
+                return CSRGraph(std::move(nodes), edges);
+            }
+
+            View view() const
+            {
+                return View(nodes.data(), nodes.size(), offsets.data(), neighbors.data(), edgeCosts.empty() ? nullptr : edgeCosts.data());
+            }
+
+            // Graph interface
+
+            const NodeType& operator[](NodeHandle node) const
+            {
+                return nodes[node];
+            }
+
+            NodeType& operator[](NodeHandle node)
+            {
+                return nodes[node];
+            }
+
+            NeighborIterator neighbor_begin(NodeHandle node) const
+            {
+                return neighbors.data() + offsets[node];
+            }
+
+            NeighborIterator neighbor_end(NodeHandle node) const
+            {
+                return neighbors.data() + offsets[node + 1];
+            }
+
+            size_t size() const
+            {
+                return nodes.size();
+            }
+
+            bool is_valid_handle(NodeHandle node) const
+            {
+                return std::size_t(node) < nodes.size();
+            }
+
+            std::size_t index_of(NodeHandle node) const
+            {
+                return node;
+            }
+
+            // CSR specific
+
+            std::size_t edge_count() const { return neighbors.size(); }
+            std::size_t degree(NodeHandle node) const { return view().degree(node); }
+            std::span<const IndexType> neighbors_of(NodeHandle node) const { return view().neighbors_of(node); }
+            bool has_edge_costs() const { return !edgeCosts.empty(); }
+            EdgeCostType edge_cost(NeighborIterator edge) const { return view().edge_cost(edge); }
+            double edge_cost(NodeHandle from, NodeHandle to) const { return view().edge_cost(from, to); }
+
+            /// bytes in use by the arrays (capacity slack not included)
+            CSRGraphFootprint footprint() const { return view().footprint(); }
+
+            /// what the same graph costs as a std::vector<std::vector<IndexType>> adjacency list plus a separate cost vector per node,
+            /// counting the vector headers and assuming no capacity slack; for comparing against the structure this replaces
+            CSRGraphFootprint adjacencyListFootprint() const
+            {
+                CSRGraphFootprint f;
+                f.nodeBytes = nodes.size() * sizeof(NodeType);
+                f.offsetBytes = nodes.size() * sizeof(std::vector<IndexType>);
+                f.neighborBytes = neighbors.size() * sizeof(IndexType);
+
+                if (has_edge_costs())
+                {
+                    f.offsetBytes += nodes.size() * sizeof(std::vector<EdgeCostType>);
+                    f.edgeCostBytes = edgeCosts.size() * sizeof(EdgeCostType);
+                }
+
+                return f;
+            }
+
+        private:
+            std::vector<NodeType> nodes;
+            std::vector<IndexType> offsets;     ///< nodes.size() + 1 entries; row n of the arrays below is [offsets[n], offsets[n + 1])
+            std::vector<IndexType> neighbors;
+            std::vector<EdgeCostType> edgeCosts; ///< parallel to neighbors, empty if built without costs
+        };
+
+        /// Cost function for CSRGraph / CSRGraphView that reads the stored edge costs
+        /// AStar() passes the neighbor iterator, so the cost is read straight from the slot parallel to the edge; the (from, to) form
+        /// scans the row of from and is only there for callers that have no iterator (e.g. reverse edges)
+        struct CSREdgeCostFunction
+        {
+            using reads_edge_costs = std::true_type;
+
+            template <typename CSR>
+            double operator()(const CSR& graph, typename CSR::NodeHandle, typename CSR::NeighborIterator edge) const
+            {
+                return double(graph.edge_cost(edge));
+            }
+
+            template <typename CSR>
+            double operator()(const CSR& graph, typename CSR::NodeHandle from, typename CSR::NodeHandle to) const
+            {
+                return graph.edge_cost(from, to);
+            }
+        };
+    }
+}
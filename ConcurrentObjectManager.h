@@ -0,0 +1,279 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+#include "ObjectHandle.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// ObjectManager variant that any number of threads can insert into, remove from and look up in at the same time, without locks
+        ///
+        /// - Storage is a fixed directory of chunks of 2^ChunkShift slots. Chunks are allocated on demand and never move or get freed
+        ///   before the manager is destroyed, so a lookup never races with a reallocation. The directory itself holds maxObjects / chunkSize
+        ///   pointers inside the manager (32KB with the default handle and chunk size), so small chunk sizes make for a large object.
+        /// - Free slot indices sit on a lock-free stack whose head carries a modification tag next to the index, so a pop can't be fooled
+        ///   by the same index being popped and pushed back in between (ABA).
+        /// - lookupObject is wait-free: one acquire load of the chunk pointer and one of the slot state.
+        /// - Reclamation is deferred: removeObject only invalidates the handle. The object is destroyed and its slot reused in reclaim(),
+        ///   which must be called at a point where no thread still uses a pointer from lookupObject (typically once per frame, between jobs).
+        ///   A pointer from lookupObject therefore stays readable until the next reclaim() even if the object is removed meanwhile.
+        template <typename ObjectType, unsigned ChunkShift = 12>
+        class ConcurrentObjectManager
+        {
+        public:
+            using Handle = ObjectHandle;
+
+            static constexpr std::size_t chunkSize = std::size_t(1) << ChunkShift;
+            static constexpr std::size_t maxObjects = std::size_t(Handle::maxIndex) + 1;
+            static constexpr std::size_t maxChunks = maxObjects / chunkSize;
+
+            static_assert(ChunkShift > 0 && ChunkShift <= Handle::indexBits, "chunk size must fit the handle index range");
+
+            ConcurrentObjectManager() = default;
+            ConcurrentObjectManager(const ConcurrentObjectManager&) = delete;
+            ConcurrentObjectManager& operator=(const ConcurrentObjectManager&) = delete;
+
+            ~ConcurrentObjectManager()
+            {
+                const std::uint32_t count = slotCount.load(std::memory_order_acquire);
+
+                for (std::uint32_t i = 0; i < count && i < maxObjects; ++i)
+                {
+                    Slot& s = slot(i);
+
+                    if (s.constructed)
+                    {
+                        s.object()->~ObjectType();
+                    }
+                }
+
+                for (auto& chunk : chunks)
+                {
+                    delete[] chunk.load(std::memory_order_relaxed);
+                }
+            }
+
+            /// live objects; only a snapshot while other threads are inserting or removing
+            std::size_t size() const
+            {
+                return liveCount.load(std::memory_order_relaxed);
+            }
+
+            /// returns a null handle (value 0) if all maxObjects slots are live or waiting for reclaim()
+            Handle insertObject(ObjectType&& object)
+            {
+                std::uint32_t index = popFree(freeHead);
+
+                if (index == noIndex)
+                {
+                    // claim a fresh slot, but never count past maxObjects: a failed insert leaves slotCount alone
+                    index = slotCount.load(std::memory_order_relaxed);
+
+                    do
+                    {
+                        if (index >= maxObjects)
+                        {
+                            assert(!"ConcurrentObjectManager is full");
+                            return Handle(0u);
+                        }
+                    }
+                    while (!slotCount.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+
+                    ensureChunk(index >> ChunkShift);
+                }
+
+                Slot& s = slot(index);
+                new (s.storage) ObjectType(std::move(object));
+                s.constructed = true;
+
+                // versions start at "1", otherwise the handle for version 0, index 0 just looks like null
+                const std::uint32_t version = versionOf(s.state.load(std::memory_order_relaxed)) + 1;
+
+                // publishes the constructed object to lookups
+                s.state.store(version | liveBit, std::memory_order_release);
+                liveCount.fetch_add(1, std::memory_order_relaxed);
+
+                return { index, version };
+            }
+
+            ObjectType* lookupObject(const Handle& handle) const
+            {
+                const std::uint32_t index = std::uint32_t(handle.index);
+                Slot* chunk = chunks[index >> ChunkShift].load(std::memory_order_acquire);
+
+                if (!chunk)
+                {
+                    return nullptr;
+                }
+
+                Slot& s = chunk[index & (chunkSize - 1)];
+
+                if (s.state.load(std::memory_order_acquire) != (handle.version | liveBit))
+                {
+                    return nullptr; // Handle is invalid or object was deleted
+                }
+
+                return s.object();
+            }
+
+            /// invalidates the handle; the object itself is destroyed by the next reclaim(). Only one of several concurrent removes of the same handle succeeds
+            bool removeObject(const Handle& handle)
+            {
+                if (!chunks[std::uint32_t(handle.index) >> ChunkShift].load(std::memory_order_acquire))
+                {
+                    return false;
+                }
+
+                const std::uint32_t index = std::uint32_t(handle.index);
+                Slot& s = slot(index);
+                std::uint32_t expected = handle.version | liveBit;
+
+                if (!s.state.compare_exchange_strong(expected, handle.version, std::memory_order_acq_rel))
+                {
+                    return false;
+                }
+
+                liveCount.fetch_sub(1, std::memory_order_relaxed);
+                push(retiredHead, index);
+                return true;
+            }
+
+            /// Destroys every removed object and makes its slot available to insertObject again.
+            /// Not safe against lookups in flight: call it once no thread holds a pointer obtained from lookupObject.
+            /// Inserts and removes may run concurrently with it
+            void reclaim()
+            {
+                // detach the whole retired list; it is private to this call from here on
+                std::uint64_t head = retiredHead.exchange(pack(noIndex, 0), std::memory_order_acquire);
+                std::uint32_t index = indexOf(head);
+
+                while (index != noIndex)
+                {
+                    Slot& s = slot(index);
+                    const std::uint32_t next = s.nextFree.load(std::memory_order_relaxed);
+
+                    s.object()->~ObjectType();
+                    s.constructed = false;
+
+                    // a slot at the last version is retired rather than reused, so its old handles can never alias a new object
+                    if (versionOf(s.state.load(std::memory_order_relaxed)) != versionMask)
+                    {
+                        push(freeHead, index);
+                    }
+
+                    index = next;
+                }
+            }
+
+        private:
+
+            static constexpr std::uint32_t versionMask = 0xFFu;
+            static constexpr std::uint32_t liveBit = 0x100u;
+            static constexpr std::uint32_t noIndex = 0xFFFFFFFFu;
+
+            struct Slot
+            {
+                std::atomic<std::uint32_t> state{0};         ///< version in the low 8 bits, liveBit while the handle is valid
+                std::atomic<std::uint32_t> nextFree{noIndex}; ///< link while on the free or retired stack
+                bool constructed = false;                     ///< only touched by the thread that owns the slot (inserter, reclaim)
+                alignas(ObjectType) unsigned char storage[sizeof(ObjectType)];
+
+                ObjectType* object()
+                {
+                    return std::launder(reinterpret_cast<ObjectType*>(storage));
+                }
+            };
+
+            static std::uint32_t versionOf(std::uint32_t state)
+            {
+                return state & versionMask;
+            }
+
+            // stack heads pack {tag, index}; the tag changes on every successful update
+
+            static std::uint64_t pack(std::uint32_t index, std::uint32_t tag)
+            {
+                return (std::uint64_t(tag) << 32) | index;
+            }
+
+            static std::uint32_t indexOf(std::uint64_t head)
+            {
+                return std::uint32_t(head);
+            }
+
+            static std::uint32_t tagOf(std::uint64_t head)
+            {
+                return std::uint32_t(head >> 32);
+            }
+
+            Slot& slot(std::uint32_t index) const
+            {
+                return chunks[index >> ChunkShift].load(std::memory_order_acquire)[index & (chunkSize - 1)];
+            }
+
+            void ensureChunk(std::uint32_t chunkIndex)
+            {
+                if (chunks[chunkIndex].load(std::memory_order_acquire))
+                {
+                    return;
+                }
+
+                Slot* fresh = new Slot[chunkSize];
+                Slot* expected = nullptr;
+
+                if (!chunks[chunkIndex].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel))
+                {
+                    delete[] fresh; // another thread got there first
+                }
+            }
+
+            void push(std::atomic<std::uint64_t>& head, std::uint32_t index)
+            {
+                Slot& s = slot(index);
+                std::uint64_t old = head.load(std::memory_order_relaxed);
+
+                do
+                {
+                    s.nextFree.store(indexOf(old), std::memory_order_relaxed);
+                }
+                while (!head.compare_exchange_weak(old, pack(index, tagOf(old) + 1), std::memory_order_release, std::memory_order_relaxed));
+            }
+
+            std::uint32_t popFree(std::atomic<std::uint64_t>& head)
+            {
+                std::uint64_t old = head.load(std::memory_order_acquire);
+
+                for (;;)
+                {
+                    const std::uint32_t index = indexOf(old);
+
+                    if (index == noIndex)
+                    {
+                        return noIndex;
+                    }
+
+                    // slots are never freed, so reading the link is safe even if another thread pops this index first; the tag then fails the CAS
+                    const std::uint32_t next = slot(index).nextFree.load(std::memory_order_relaxed);
+
+                    if (head.compare_exchange_weak(old, pack(next, tagOf(old) + 1), std::memory_order_acquire, std::memory_order_acquire))
+                    {
+                        return index;
+                    }
+                }
+            }
+
+            std::array<std::atomic<Slot*>, maxChunks> chunks{};
+            std::atomic<std::uint32_t> slotCount{0};     ///< high water mark of slot indices handed out
+            std::atomic<std::size_t> liveCount{0};
+            std::atomic<std::uint64_t> freeHead{pack(noIndex, 0)};
+            std::atomic<std::uint64_t> retiredHead{pack(noIndex, 0)};
+        };
+    }
+}
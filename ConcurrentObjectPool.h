@@ -0,0 +1,274 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ObjectPoolDynamic.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// Object Pool (Concurrent)
+        /// ObjectPoolDynamic for many threads, in three layers (the magazine design of Bonwick's slab allocator):
+        /// - every thread works through its own Cache holding up to two magazines of MagazineSize objects, so most acquires / releases
+        ///   touch only thread local memory;
+        /// - a lock-free depot swaps full magazines for empty ones (and back) between threads;
+        /// - only when the depot runs dry does a cache lock the backing ObjectPoolDynamic, to refill or flush a whole magazine at once,
+        ///   growing it through the Initializer as usual.
+        /// Objects move in and out as with ObjectPoolDynamic (acquire(T&) / release(T&&)).
+        /// Usage: each worker thread creates one ConcurrentObjectPool::Cache and keeps it for its lifetime; caches must be destroyed before the pool
+        template<typename T, typename Initializer, std::size_t ExpansionSize = 1, std::size_t MagazineSize = 32>
+        class ConcurrentObjectPool
+        {
+            static constexpr std::uint32_t noMagazine = 0xFFFFFFFFu;
+
+            struct Magazine
+            {
+                std::vector<T> objects;
+                std::atomic<std::uint32_t> next{noMagazine}; ///< link while on a depot stack
+            };
+
+        public:
+
+            static_assert(MagazineSize > 0, "magazines need room for at least one object");
+
+            /// magazineCount bounds the magazines shared by all caches (two per cache plus what sits in the depot);
+            /// when they run out, caches fall back to the locked backing pool
+            ConcurrentObjectPool(const Initializer& initFunctor, int reserveSize = 0, std::size_t magazineCount = 256)
+                : backing(initFunctor, reserveSize), magazines(new Magazine[magazineCount])
+            {
+                assert(magazineCount < noMagazine && "magazine indices must fit the depot links");
+
+                for (std::size_t i = magazineCount; i > 0; --i)
+                {
+                    magazines[i - 1].objects.reserve(MagazineSize);
+                    push(emptyDepot, std::uint32_t(i - 1));
+                }
+            }
+
+            ConcurrentObjectPool(const ConcurrentObjectPool&) = delete;
+            ConcurrentObjectPool& operator=(const ConcurrentObjectPool&) = delete;
+
+            ~ConcurrentObjectPool()
+            {
+                assert(activeCaches.load() == 0 && "destroy every Cache before its pool");
+            }
+
+            /// Per thread front end; not thread safe itself. Everything it holds goes back to the depot when it is flushed or destroyed
+            class Cache
+            {
+            public:
+                explicit Cache(ConcurrentObjectPool& pool) : pool(pool)
+                {
+                    pool.activeCaches.fetch_add(1, std::memory_order_relaxed);
+                    loaded = pool.pop(pool.emptyDepot);
+                    previous = pool.pop(pool.emptyDepot);
+                }
+
+                Cache(const Cache&) = delete;
+                Cache& operator=(const Cache&) = delete;
+
+                ~Cache()
+                {
+                    flush();
+                    pool.activeCaches.fetch_sub(1, std::memory_order_relaxed);
+                }
+
+                bool acquire(T& outObj)
+                {
+                    if (loaded == noMagazine || objects(loaded).empty())
+                    {
+                        if (previous != noMagazine && !objects(previous).empty())
+                        {
+                            std::swap(loaded, previous);
+                        }
+                        else if (!exchangeForFull())
+                        {
+                            return refill(outObj);
+                        }
+                    }
+
+                    std::vector<T>& magazine = objects(loaded);
+                    outObj = std::move(magazine.back());
+                    magazine.pop_back();
+                    return true;
+                }
+
+                void release(T&& obj)
+                {
+                    if (loaded == noMagazine || objects(loaded).size() == MagazineSize)
+                    {
+                        if (previous != noMagazine && objects(previous).size() < MagazineSize)
+                        {
+                            std::swap(loaded, previous);
+                        }
+                        else if (!exchangeForEmpty())
+                        {
+                            flushToBacking(std::move(obj));
+                            return;
+                        }
+                    }
+
+                    objects(loaded).push_back(std::move(obj));
+                }
+
+                /// hands both magazines back to the depot (e.g. before a worker goes idle for a while)
+                void flush()
+                {
+                    giveBack(loaded);
+                    giveBack(previous);
+                    loaded = noMagazine;
+                    previous = noMagazine;
+                }
+
+            private:
+
+                std::vector<T>& objects(std::uint32_t magazine)
+                {
+                    return pool.magazines[magazine].objects;
+                }
+
+                void giveBack(std::uint32_t magazine)
+                {
+                    if (magazine != noMagazine)
+                    {
+                        pool.push(objects(magazine).empty() ? pool.emptyDepot : pool.fullDepot, magazine);
+                    }
+                }
+
+                /// loaded is empty (or missing): trade it for a full magazine from the depot
+                bool exchangeForFull()
+                {
+                    const std::uint32_t full = pool.pop(pool.fullDepot);
+
+                    if (full == noMagazine)
+                    {
+                        return false;
+                    }
+
+                    giveBack(loaded);
+                    loaded = full;
+                    return true;
+                }
+
+                /// loaded and previous are full (or missing): previous goes to the depot, loaded becomes previous, and an empty magazine is loaded
+                bool exchangeForEmpty()
+                {
+                    const std::uint32_t empty = pool.pop(pool.emptyDepot);
+
+                    if (empty == noMagazine)
+                    {
+                        return false;
+                    }
+
+                    giveBack(previous);
+                    previous = loaded;
+                    loaded = empty;
+                    return true;
+                }
+
+                /// nothing in the depot: fill the loaded magazine straight from the backing pool in one locked batch
+                bool refill(T& outObj)
+                {
+                    if (loaded == noMagazine)
+                    {
+                        loaded = pool.pop(pool.emptyDepot);
+                    }
+
+                    std::lock_guard<std::mutex> lock(pool.backingMutex);
+
+                    if (loaded == noMagazine)
+                    {
+                        // no magazine to spare anywhere; serve just this one
+                        return pool.backing.acquire(outObj);
+                    }
+
+                    std::vector<T>& magazine = objects(loaded);
+                    pool.backing.acquireBatch(magazine, MagazineSize - magazine.size());
+                    outObj = std::move(magazine.back());
+                    magazine.pop_back();
+                    return true;
+                }
+
+                /// no empty magazine in the depot: return the loaded magazine to the backing pool in one locked batch
+                void flushToBacking(T&& obj)
+                {
+                    std::lock_guard<std::mutex> lock(pool.backingMutex);
+
+                    if (loaded == noMagazine)
+                    {
+                        pool.backing.release(std::move(obj));
+                        return;
+                    }
+
+                    std::vector<T>& magazine = objects(loaded);
+                    pool.backing.releaseBatch(magazine.begin(), magazine.end());
+                    magazine.clear();
+                    magazine.push_back(std::move(obj));
+                }
+
+                ConcurrentObjectPool& pool;
+                std::uint32_t loaded = noMagazine;
+                std::uint32_t previous = noMagazine;
+            };
+
+        private:
+
+            // depot stacks hold magazine indices; heads pack {tag, index}, the tag changing on every update so a pop can't be fooled by ABA
+
+            static std::uint64_t pack(std::uint32_t index, std::uint32_t tag)
+            {
+                return (std::uint64_t(tag) << 32) | index;
+            }
+
+            void push(std::atomic<std::uint64_t>& head, std::uint32_t magazine)
+            {
+                std::uint64_t old = head.load(std::memory_order_relaxed);
+
+                do
+                {
+                    magazines[magazine].next.store(std::uint32_t(old), std::memory_order_relaxed);
+                }
+                while (!head.compare_exchange_weak(old, pack(magazine, std::uint32_t(old >> 32) + 1), std::memory_order_release, std::memory_order_relaxed));
+            }
+
+            std::uint32_t pop(std::atomic<std::uint64_t>& head)
+            {
+                std::uint64_t old = head.load(std::memory_order_acquire);
+
+                for (;;)
+                {
+                    const std::uint32_t magazine = std::uint32_t(old);
+
+                    if (magazine == noMagazine)
+                    {
+                        return noMagazine;
+                    }
+
+                    // magazines live as long as the pool, so reading the link of one another thread just popped is harmless; the tag fails the CAS
+                    const std::uint32_t next = magazines[magazine].next.load(std::memory_order_relaxed);
+
+                    if (head.compare_exchange_weak(old, pack(next, std::uint32_t(old >> 32) + 1), std::memory_order_acquire, std::memory_order_acquire))
+                    {
+                        return magazine;
+                    }
+                }
+            }
+
+            ObjectPoolDynamic<T, Initializer, ExpansionSize> backing;
+            std::mutex backingMutex;
+
+            std::unique_ptr<Magazine[]> magazines;
+            std::atomic<std::uint64_t> fullDepot{pack(noMagazine, 0)};  ///< magazines holding objects (not necessarily MagazineSize of them)
+            std::atomic<std::uint64_t> emptyDepot{pack(noMagazine, 0)};
+            std::atomic<std::size_t> activeCaches{0};
+        };
+
+    }
+}
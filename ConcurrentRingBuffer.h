@@ -0,0 +1,288 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+// destructive interference size; std::hardware_destructive_interference_size isn't available everywhere, and 64 is right for the targets we ship
+constexpr std::size_t ringBufferCacheLine = 64;
+
+/// Lock-free ring for exactly one producer thread and one consumer thread
+/// head (consumer) and tail (producer) are free running counters on separate cache lines; each side also keeps a cached copy of the other side's
+/// counter and only reloads it when the ring looks full / empty, so in steady state neither side touches the other's cache line.
+/// T must be default constructible and move assignable (slots are a std::array<T, Capacity>, as in RingBuffer)
+template <typename T, std::size_t Capacity>
+class SPSCRingBuffer
+{
+    static_assert(Capacity > 0, "ring needs at least one slot");
+
+    alignas(ringBufferCacheLine) std::atomic<std::size_t> head{0}; // next element to pop, written by the consumer
+    std::size_t cachedTail = 0;                                    // consumer's copy of tail
+
+    alignas(ringBufferCacheLine) std::atomic<std::size_t> tail{0}; // next slot to push, written by the producer
+    std::size_t cachedHead = 0;                                    // producer's copy of head
+
+    alignas(ringBufferCacheLine) std::array<T, Capacity> buffer;
+
+    // slots the producer may fill, reloading head only if the cached copy says fewer than wanted
+    std::size_t writable(std::size_t t, std::size_t wanted)
+    {
+        if (Capacity - (t - cachedHead) < wanted)
+        {
+            cachedHead = head.load(std::memory_order_acquire);
+        }
+
+        return Capacity - (t - cachedHead);
+    }
+
+    std::size_t readable(std::size_t h, std::size_t wanted)
+    {
+        if (cachedTail - h < wanted)
+        {
+            cachedTail = tail.load(std::memory_order_acquire);
+        }
+
+        return cachedTail - h;
+    }
+
+public:
+
+    // producer side
+
+    bool try_push(const T& val)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+
+        if (writable(t, 1) == 0)
+        {
+            return false;
+        }
+
+        buffer[t % Capacity] = val;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(T&& val)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+
+        if (writable(t, 1) == 0)
+        {
+            return false;
+        }
+
+        buffer[t % Capacity] = std::move(val);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// pushes as many of vals as fit, publishing them with a single store; returns how many were pushed
+    std::size_t try_push_n(std::span<const T> vals)
+    {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        const std::size_t n = std::min(vals.size(), writable(t, vals.size()));
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            buffer[(t + i) % Capacity] = vals[i];
+        }
+
+        tail.store(t + n, std::memory_order_release);
+        return n;
+    }
+
+    // consumer side
+
+    bool try_pop(T& out)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+
+        if (readable(h, 1) == 0)
+        {
+            return false;
+        }
+
+        out = std::move(buffer[h % Capacity]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// pops up to out.size() elements into out, freeing their slots with a single store; returns how many were popped
+    std::size_t try_pop_n(std::span<T> out)
+    {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        const std::size_t n = std::min(out.size(), readable(h, out.size()));
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            out[i] = std::move(buffer[(h + i) % Capacity]);
+        }
+
+        head.store(h + n, std::memory_order_release);
+        return n;
+    }
+
+    /// exact only when called from the producer or consumer thread while the other one is idle
+    std::size_t size_approx() const
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const
+    {
+        return Capacity;
+    }
+};
+
+/// Bounded lock-free ring for any number of producer and consumer threads (Vyukov's MPMC queue)
+/// Every slot carries a sequence number telling which lap of the ring it is ready for: a producer may fill slot pos % Capacity when its
+/// sequence equals pos, a consumer may empty it when the sequence equals pos + 1. Producers and consumers only contend on their own counter.
+/// Capacity must be a power of two. T must be default constructible and move assignable
+template <typename T, std::size_t Capacity>
+class MPMCRingBuffer
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "MPMC ring capacity must be a power of two");
+
+    static constexpr std::size_t mask = Capacity - 1;
+
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        T data;
+    };
+
+    alignas(ringBufferCacheLine) std::atomic<std::size_t> enqueuePos{0};
+    alignas(ringBufferCacheLine) std::atomic<std::size_t> dequeuePos{0};
+    alignas(ringBufferCacheLine) std::array<Cell, Capacity> cells;
+
+    // claims up to wanted consecutive slots starting at the shared position pos whose sequence is pos + i + lapOffset; returns the claim start
+    // and count (0 if the ring is full / empty). Claiming a run means scanning it first, so one CAS covers the whole batch
+    std::size_t claim(std::atomic<std::size_t>& position, std::size_t lapOffset, std::size_t wanted, std::size_t& start)
+    {
+        std::size_t pos = position.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            std::size_t n = 0;
+            bool stale = false;
+
+            while (n < wanted)
+            {
+                const std::size_t seq = cells[(pos + n) & mask].sequence.load(std::memory_order_acquire);
+                const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos + n + lapOffset);
+
+                if (diff != 0)
+                {
+                    // diff > 0 on the first slot: someone else claimed it already, reload the position and retry
+                    stale = (n == 0 && diff > 0);
+                    break;
+                }
+
+                ++n;
+            }
+
+            if (n == 0)
+            {
+                if (!stale)
+                {
+                    return 0;
+                }
+
+                pos = position.load(std::memory_order_relaxed);
+                continue;
+            }
+
+            if (position.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+            {
+                start = pos;
+                return n;
+            }
+        }
+    }
+
+public:
+
+    MPMCRingBuffer()
+    {
+        for (std::size_t i = 0; i < Capacity; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCRingBuffer(const MPMCRingBuffer&) = delete;
+    MPMCRingBuffer& operator=(const MPMCRingBuffer&) = delete;
+
+    bool try_push(const T& val)
+    {
+        return try_push_n(std::span<const T>(&val, 1)) == 1;
+    }
+
+    bool try_push(T&& val)
+    {
+        std::size_t pos;
+
+        if (claim(enqueuePos, 0, 1, pos) == 0)
+        {
+            return false;
+        }
+
+        Cell& cell = cells[pos & mask];
+        cell.data = std::move(val);
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// pushes as many of vals as there are free slots, claiming them with one CAS; returns how many were pushed
+    std::size_t try_push_n(std::span<const T> vals)
+    {
+        std::size_t pos;
+        const std::size_t n = vals.empty() ? 0 : claim(enqueuePos, 0, vals.size(), pos);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            Cell& cell = cells[(pos + i) & mask];
+            cell.data = vals[i];
+            cell.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+
+        return n;
+    }
+
+    bool try_pop(T& out)
+    {
+        return try_pop_n(std::span<T>(&out, 1)) == 1;
+    }
+
+    /// pops up to out.size() elements, claiming them with one CAS; returns how many were popped
+    std::size_t try_pop_n(std::span<T> out)
+    {
+        std::size_t pos;
+        const std::size_t n = out.empty() ? 0 : claim(dequeuePos, 1, out.size(), pos);
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            Cell& cell = cells[(pos + i) & mask];
+            out[i] = std::move(cell.data);
+            cell.sequence.store(pos + i + Capacity, std::memory_order_release);
+        }
+
+        return n;
+    }
+
+    /// a snapshot; may be off while other threads push or pop
+    std::size_t size_approx() const
+    {
+        const std::size_t e = enqueuePos.load(std::memory_order_relaxed);
+        const std::size_t d = dequeuePos.load(std::memory_order_relaxed);
+        return e > d ? e - d : 0;
+    }
+
+    std::size_t capacity() const
+    {
+        return Capacity;
+    }
+};
@@ -0,0 +1,334 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "AStar.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// Incremental planner (D* Lite) over the Graph concept
+        /// Plans backwards from the goal and keeps its g / rhs values between calls, so when edge costs change
+        /// (a door closes, a wall is destroyed) only the part of the search the change affects is repaired instead of searching from scratch.
+        /// The agent may also move along the path between replans with moveStart().
+        ///
+        /// Usage: begin(start, goal); plan(); ... on change: notifyEdgeChanged(u, v) for every edge whose cost changed, then plan() again.
+        /// costFunction is called again for notified edges, so it must already return the new cost; return infinity for an impassable edge.
+        /// The neighbor relation must be symmetric (undirected graph), since predecessors are found through the same neighbor lists.
+        /// If an edge disappears from the neighbor lists altogether (e.g. a grid cell becomes blocked), notify it for both of its former endpoints.
+        template <Graph GraphType, CostFunction<GraphType> CostFn, CostFunction<GraphType> HeuristicFn>
+        class DStarLite
+        {
+        public:
+            using NodeHandle = typename GraphType::NodeHandle;
+
+            DStarLite(const GraphType& graph, CostFn costFunction, HeuristicFn heuristic)
+                : graph(graph), costFunction(costFunction), heuristic(heuristic)
+            {
+            }
+
+            /// starts planning for a new start / goal pair, dropping all state from earlier plans
+            void begin(const NodeHandle& start, const NodeHandle& goal)
+            {
+                states.clear();
+                queue.clear();
+                path.clear();
+                stats.reset();
+
+                this->start = start;
+                this->goal = goal;
+                lastStart = start;
+                keyModifier = 0.0;
+
+                valid = graph.is_valid_handle(start) && graph.is_valid_handle(goal);
+
+                if (valid)
+                {
+                    State& g = state(goal);
+                    g.rhs = 0.0;
+                    enqueue(goal, g);
+                }
+            }
+
+            /// moves the start of the plan (typically to the next node on the path once the agent reaches it)
+            void moveStart(const NodeHandle& newStart)
+            {
+                start = newStart;
+                valid = valid && graph.is_valid_handle(newStart);
+            }
+
+            /// tells the planner the cost of the edge between u and v changed (in either direction)
+            void notifyEdgeChanged(const NodeHandle& u, const NodeHandle& v)
+            {
+                if (!valid)
+                {
+                    return;
+                }
+
+                if (lastStart != start)
+                {
+                    // queued keys were computed against the old start; raise the bound instead of re-keying the whole queue
+                    keyModifier += heuristic(graph, lastStart, start);
+                    ++stats.heuristicCalls;
+                    lastStart = start;
+                }
+
+                updateVertex(u);
+                updateVertex(v);
+            }
+
+            /// repairs the plan and returns the path from the current start to the goal (both included), or an empty view if the goal can't be reached
+            /// The view points into the planner and is valid until the next call to plan()
+            std::span<const NodeHandle> plan()
+            {
+                path.clear();
+
+                if (!valid)
+                {
+                    return {};
+                }
+
+                computeShortestPath();
+
+                // the loop may stop with start overconsistent (g above rhs), so rhs is the value to trust here
+                if (state(start).rhs == infinity)
+                {
+                    return {};
+                }
+
+                // follow the cheapest successor down from start; bounded in case costs changed without a notification
+                NodeHandle node = start;
+                path.push_back(node);
+
+                for (std::size_t steps = 0; node != goal && steps < graph.size(); ++steps)
+                {
+                    double best = infinity;
+                    NodeHandle next = node;
+
+                    for (auto it = graph.neighbor_begin(node); it != graph.neighbor_end(node); ++it)
+                    {
+                        const double c = costFunction(graph, node, *it) + g(*it);
+
+                        if (c < best)
+                        {
+                            best = c;
+                            next = *it;
+                        }
+                    }
+
+                    if (best == infinity)
+                    {
+                        path.clear();
+                        return {};
+                    }
+
+                    node = next;
+                    path.push_back(node);
+                }
+
+                if (node != goal)
+                {
+                    path.clear();
+                    return {};
+                }
+
+                return path;
+            }
+
+            /// cost of the current plan from start to goal (infinity if unreachable); only meaningful after plan()
+            double pathCost() const
+            {
+                auto it = states.find(start);
+                return it == states.end() ? infinity : it->second.rhs;
+            }
+
+            /// counters accumulated since begin(); expansions measure how much work each repair took
+            AStarStats stats;
+
+        private:
+
+            static constexpr double infinity = std::numeric_limits<double>::infinity();
+
+            struct Key
+            {
+                double primary;
+                double secondary;
+
+                bool operator<(const Key& other) const
+                {
+                    return primary < other.primary || (primary == other.primary && secondary < other.secondary);
+                }
+
+                bool operator==(const Key& other) const
+                {
+                    return primary == other.primary && secondary == other.secondary;
+                }
+            };
+
+            struct State
+            {
+                double g = infinity;
+                double rhs = infinity;
+                Key key = {infinity, infinity};
+                bool queued = false;
+            };
+
+            struct QueueEntry
+            {
+                Key key;
+                NodeHandle node;
+
+                bool operator>(const QueueEntry& other) const
+                {
+                    return other.key < key;
+                }
+            };
+
+            State& state(const NodeHandle& node)
+            {
+                return states[node];
+            }
+
+            double g(const NodeHandle& node) const
+            {
+                auto it = states.find(node);
+                return it == states.end() ? infinity : it->second.g;
+            }
+
+            Key calculateKey(const NodeHandle& node, const State& s)
+            {
+                const double m = std::min(s.g, s.rhs);
+                ++stats.heuristicCalls;
+                return {m + heuristic(graph, start, node) + keyModifier, m};
+            }
+
+            /// queues the node with a fresh key; older entries for it become stale and are skipped when popped
+            void enqueue(const NodeHandle& node, State& s)
+            {
+                s.key = calculateKey(node, s);
+                s.queued = true;
+                queue.push_back({s.key, node});
+                std::push_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+                ++stats.pushes;
+            }
+
+            /// drops stale entries off the top of the queue
+            void cleanTop()
+            {
+                while (!queue.empty())
+                {
+                    const QueueEntry& top = queue.front();
+                    auto it = states.find(top.node);
+
+                    if (it != states.end() && it->second.queued && it->second.key == top.key)
+                    {
+                        return;
+                    }
+
+                    std::pop_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+                    queue.pop_back();
+                    ++stats.duplicatePops;
+                }
+            }
+
+            void updateVertex(const NodeHandle& node)
+            {
+                State& s = state(node);
+
+                if (node != goal)
+                {
+                    double rhs = infinity;
+
+                    for (auto it = graph.neighbor_begin(node); it != graph.neighbor_end(node); ++it)
+                    {
+                        rhs = std::min(rhs, costFunction(graph, node, *it) + g(*it));
+                    }
+
+                    s.rhs = rhs;
+                }
+
+                if (s.g != s.rhs)
+                {
+                    enqueue(node, s);
+                }
+                else
+                {
+                    s.queued = false;
+                }
+            }
+
+            /// Nodes along a straight run share the same primary key in exact arithmetic and are told apart by the secondary key,
+            /// but g + h + km rounds differently for each of them; the stop test treats primaries this close as a tie and keeps expanding
+            static double tieSlack(double primary)
+            {
+                return 1e-9 * std::max(1.0, std::abs(primary));
+            }
+
+            void computeShortestPath()
+            {
+                for (;;)
+                {
+                    cleanTop();
+
+                    State& startState = state(start);
+                    const Key startKey = calculateKey(start, startState);
+
+                    if (queue.empty() || (queue.front().key.primary > startKey.primary + tieSlack(startKey.primary) && startState.rhs <= startState.g))
+                    {
+                        return;
+                    }
+
+                    const QueueEntry top = queue.front();
+                    State& u = state(top.node);
+                    const Key newKey = calculateKey(top.node, u);
+
+                    if (top.key < newKey)
+                    {
+                        // key went stale because the start moved; requeue with the up to date key
+                        enqueue(top.node, u);
+                        continue;
+                    }
+
+                    std::pop_heap(queue.begin(), queue.end(), std::greater<QueueEntry>());
+                    queue.pop_back();
+                    u.queued = false;
+                    ++stats.expansions;
+
+                    if (u.g > u.rhs)
+                    {
+                        u.g = u.rhs;
+                    }
+                    else
+                    {
+                        u.g = infinity;
+                        updateVertex(top.node);
+                    }
+
+                    for (auto it = graph.neighbor_begin(top.node); it != graph.neighbor_end(top.node); ++it)
+                    {
+                        updateVertex(*it);
+                    }
+                }
+            }
+
+            const GraphType& graph;
+            CostFn costFunction;
+            HeuristicFn heuristic;
+
+            std::unordered_map<NodeHandle, State> states; ///< node pointers stay valid across insertions, so State& can be held while others are added
+            std::vector<QueueEntry> queue;                ///< binary min-heap with lazy deletion
+            std::vector<NodeHandle> path;
+
+            NodeHandle start{};
+            NodeHandle goal{};
+            NodeHandle lastStart{};
+            double keyModifier = 0.0;
+            bool valid = false;
+        };
+    }
+}
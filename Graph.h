@@ -1,4 +1,6 @@
+#pragma once
 #include <concepts>
+#include <cstddef>
 #include <iterator>
 
 namespace Virtuoso
@@ -28,5 +30,13 @@ namespace Virtuoso
             { graph.is_valid_handle(nh) } -> std::same_as<bool>;
         };
 
+        /// Graph whose node handles map one-to-one onto the index range [0, graph.size())
+        /// Searches can keep their per node bookkeeping in flat arrays instead of hash maps
+        template<typename G>
+        concept DenseIndexedGraph = Graph<G> && requires(const G& graph, typename G::NodeHandle nh)
+        {
+            { graph.index_of(nh) } -> std::convertible_to<std::size_t>;
+        };
+
     }
 }
\ No newline at end of file
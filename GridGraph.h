@@ -0,0 +1,181 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Graph.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// 8-connected uniform cost grid graph (satisfies DenseIndexedGraph)
+        /// Node handles are cell indices, y * width + x. Each cell stores a walkable flag (nonzero = walkable).
+        /// Straight moves cost 1 and diagonal moves cost sqrt(2); a diagonal move is only allowed when both orthogonal cells next to it are walkable (no corner cutting)
+        class GridGraph
+        {
+        public:
+            using NodeType = std::uint8_t;
+            using NodeHandle = std::uint32_t;
+
+            static constexpr int directionX[8] = { 1, -1, 0,  0, 1, -1,  1, -1 };
+            static constexpr int directionY[8] = { 0,  0, 1, -1, 1,  1, -1, -1 };
+
+            /// walks the legal moves out of a cell in direction order
+            class NeighborIterator
+            {
+            public:
+                using iterator_category = std::forward_iterator_tag;
+                using value_type = NodeHandle;
+                using difference_type = std::ptrdiff_t;
+                using pointer = const NodeHandle*;
+                using reference = NodeHandle;
+
+                NeighborIterator() = default;
+
+                NeighborIterator(const GridGraph* grid, NodeHandle node, int direction)
+                    : grid(grid), node(node), direction(direction)
+                {
+                    skipBlocked();
+                }
+
+                NodeHandle operator*() const
+                {
+                    return NodeHandle(node + directionY[direction] * int(grid->width()) + directionX[direction]);
+                }
+
+                NeighborIterator& operator++()
+                {
+                    ++direction;
+                    skipBlocked();
+                    return *this;
+                }
+
+                NeighborIterator operator++(int)
+                {
+                    NeighborIterator temp = *this;
+                    ++(*this);
+                    return temp;
+                }
+
+                bool operator==(const NeighborIterator& other) const
+                {
+                    return direction == other.direction;
+                }
+
+                bool operator!=(const NeighborIterator& other) const
+                {
+                    return direction != other.direction;
+                }
+
+            private:
+
+                void skipBlocked()
+                {
+                    const int x = grid->x_of(node);
+                    const int y = grid->y_of(node);
+
+                    while (direction < 8 && !grid->can_step(x, y, directionX[direction], directionY[direction]))
+                    {
+                        ++direction;
+                    }
+                }
+
+                const GridGraph* grid = nullptr;
+                NodeHandle node = 0;
+                int direction = 8;
+            };
+
+            GridGraph() = default;
+
+            GridGraph(std::uint32_t width, std::uint32_t height, bool walkable = true)
+                : gridWidth(width), gridHeight(height), cells(std::size_t(width) * height, NodeType(walkable ? 1 : 0))
+            {
+            }
+
+            std::uint32_t width() const { return gridWidth; }
+            std::uint32_t height() const { return gridHeight; }
+
+            NodeHandle handle_of(int x, int y) const { return NodeHandle(y * int(gridWidth) + x); }
+            int x_of(NodeHandle node) const { return int(node % gridWidth); }
+            int y_of(NodeHandle node) const { return int(node / gridWidth); }
+
+            bool in_bounds(int x, int y) const
+            {
+                return x >= 0 && y >= 0 && x < int(gridWidth) && y < int(gridHeight);
+            }
+
+            /// out of bounds cells count as blocked
+            bool is_walkable(int x, int y) const
+            {
+                return in_bounds(x, y) && cells[handle_of(x, y)] != 0;
+            }
+
+            void set_walkable(int x, int y, bool walkable)
+            {
+                cells[handle_of(x, y)] = NodeType(walkable ? 1 : 0);
+            }
+
+            /// true if a single move from (x, y) by (dx, dy) is legal (target walkable, no corner cutting on diagonals)
+            bool can_step(int x, int y, int dx, int dy) const
+            {
+                if (!is_walkable(x + dx, y + dy))
+                {
+                    return false;
+                }
+
+                return dx == 0 || dy == 0 || (is_walkable(x + dx, y) && is_walkable(x, y + dy));
+            }
+
+            // Graph interface
+
+            const NodeType& operator[](NodeHandle node) const
+            {
+                return cells[node];
+            }
+
+            NeighborIterator neighbor_begin(NodeHandle node) const
+            {
+                return NeighborIterator(this, node, cells[node] ? 0 : 8);
+            }
+
+            NeighborIterator neighbor_end(NodeHandle node) const
+            {
+                return NeighborIterator(this, node, 8);
+            }
+
+            size_t size() const
+            {
+                return cells.size();
+            }
+
+            bool is_valid_handle(NodeHandle node) const
+            {
+                return node < cells.size();
+            }
+
+            std::size_t index_of(NodeHandle node) const
+            {
+                return node;
+            }
+
+        private:
+            std::uint32_t gridWidth = 0;
+            std::uint32_t gridHeight = 0;
+            std::vector<NodeType> cells;
+        };
+
+        /// Octile distance between two cells; the exact move cost for neighboring cells and an admissible, consistent heuristic otherwise
+        struct GridOctileDistance
+        {
+            double operator()(const GridGraph& grid, GridGraph::NodeHandle a, GridGraph::NodeHandle b) const
+            {
+                const int dx = std::abs(grid.x_of(a) - grid.x_of(b));
+                const int dy = std::abs(grid.y_of(a) - grid.y_of(b));
+                constexpr double diagonalExtra = 1.4142135623730951 - 1.0;
+                return double(std::max(dx, dy)) + diagonalExtra * double(std::min(dx, dy));
+            }
+        };
+    }
+}
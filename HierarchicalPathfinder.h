@@ -0,0 +1,918 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "AStar.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// View of a graph restricted to the nodes of one cluster, so AStar() can run inside a single cluster
+        /// Neighbors outside the cluster are skipped; the view is dense-indexed whenever the underlying graph is
+        template <Graph GraphType, typename ClusterFn>
+        class ClusterView
+        {
+        public:
+            using NodeType = typename GraphType::NodeType;
+            using NodeHandle = typename GraphType::NodeHandle;
+            using BaseIterator = typename GraphType::NeighborIterator;
+            using ClusterId = std::uint32_t;
+
+            class NeighborIterator
+            {
+            public:
+                NeighborIterator() = default;
+
+                NeighborIterator(const ClusterView* view, BaseIterator it, BaseIterator end)
+                    : view(view), it(it), end(end)
+                {
+                    skipOutside();
+                }
+
+                NodeHandle operator*() const
+                {
+                    return *it;
+                }
+
+                NeighborIterator& operator++()
+                {
+                    ++it;
+                    skipOutside();
+                    return *this;
+                }
+
+                bool operator==(const NeighborIterator& other) const
+                {
+                    return it == other.it;
+                }
+
+                bool operator!=(const NeighborIterator& other) const
+                {
+                    return it != other.it;
+                }
+
+            private:
+
+                void skipOutside()
+                {
+                    while (it != end && !view->contains(*it))
+                    {
+                        ++it;
+                    }
+                }
+
+                const ClusterView* view = nullptr;
+                BaseIterator it;
+                BaseIterator end;
+            };
+
+            ClusterView(const GraphType& graph, const ClusterFn& clusterOf, ClusterId cluster)
+                : graph(&graph), clusterOf(&clusterOf), cluster(cluster)
+            {
+            }
+
+            bool contains(const NodeHandle& node) const
+            {
+                return ClusterId((*clusterOf)(*graph, node)) == cluster;
+            }
+
+            const NodeType& operator[](const NodeHandle& node) const
+            {
+                return (*graph)[node];
+            }
+
+            NeighborIterator neighbor_begin(const NodeHandle& node) const
+            {
+                return NeighborIterator(this, graph->neighbor_begin(node), graph->neighbor_end(node));
+            }
+
+            NeighborIterator neighbor_end(const NodeHandle& node) const
+            {
+                return NeighborIterator(this, graph->neighbor_end(node), graph->neighbor_end(node));
+            }
+
+            size_t size() const
+            {
+                return graph->size();
+            }
+
+            bool is_valid_handle(const NodeHandle& node) const
+            {
+                return graph->is_valid_handle(node) && contains(node);
+            }
+
+            std::size_t index_of(const NodeHandle& node) const requires DenseIndexedGraph<GraphType>
+            {
+                return graph->index_of(node);
+            }
+
+            const GraphType& base() const
+            {
+                return *graph;
+            }
+
+        private:
+            const GraphType* graph;
+            const ClusterFn* clusterOf;
+            ClusterId cluster;
+        };
+
+        /// Graph over the entrance nodes of a HierarchicalPathfinder; each edge carries the precomputed cost of the path it stands for
+        template <typename BaseHandle>
+        class AbstractGraph
+        {
+        public:
+            using NodeType = BaseHandle;
+            using NodeHandle = std::uint32_t;
+
+            struct Edge
+            {
+                NodeHandle to;
+                double cost;
+            };
+
+            class NeighborIterator
+            {
+            public:
+                NeighborIterator() = default;
+                explicit NeighborIterator(const Edge* edge) : edge(edge) {}
+
+                NodeHandle operator*() const { return edge->to; }
+                NeighborIterator& operator++() { ++edge; return *this; }
+                bool operator==(const NeighborIterator& other) const { return edge == other.edge; }
+                bool operator!=(const NeighborIterator& other) const { return edge != other.edge; }
+
+                const Edge* edge = nullptr;
+            };
+
+            const NodeType& operator[](NodeHandle node) const { return nodes[node]; }
+            NeighborIterator neighbor_begin(NodeHandle node) const { return NeighborIterator(edges[node].data()); }
+            NeighborIterator neighbor_end(NodeHandle node) const { return NeighborIterator(edges[node].data() + edges[node].size()); }
+            size_t size() const { return nodes.size(); }
+            bool is_valid_handle(NodeHandle node) const { return node < nodes.size(); }
+            std::size_t index_of(NodeHandle node) const { return node; }
+
+            /// cost stored on the edge it points at
+            double edge_cost(NeighborIterator it) const
+            {
+                return it.edge->cost;
+            }
+
+            /// cheapest edge from -> to; a scan of from's edges, meant for summing up a finished path rather than for searching
+            double edge_cost(NodeHandle from, NodeHandle to) const
+            {
+                double best = std::numeric_limits<double>::max();
+
+                for (const Edge& e : edges[from])
+                {
+                    if (e.to == to && e.cost < best)
+                    {
+                        best = e.cost;
+                    }
+                }
+
+                return best;
+            }
+
+            std::vector<BaseHandle> nodes;          ///< underlying graph node of each abstract node
+            std::vector<std::vector<Edge> > edges;  ///< outgoing edges per abstract node
+        };
+
+        /// EdgeCostFunction for AbstractGraph: reads the cost off the edge being relaxed
+        struct AbstractEdgeCost
+        {
+            using reads_edge_costs = std::true_type;
+
+            template <typename BaseHandle>
+            double operator()(const AbstractGraph<BaseHandle>& graph, std::uint32_t, typename AbstractGraph<BaseHandle>::NeighborIterator edge) const
+            {
+                return graph.edge_cost(edge);
+            }
+
+            template <typename BaseHandle>
+            double operator()(const AbstractGraph<BaseHandle>& graph, std::uint32_t from, std::uint32_t to) const
+            {
+                return graph.edge_cost(from, to);
+            }
+        };
+
+        /// Waypoints of a hierarchical path: start, the entrances it passes through, target
+        /// Consecutive waypoints in different clusters are joined by a single edge; the ones in the same cluster by an intra-cluster path
+        /// that HierarchicalPathfinder::refineSegment() computes on demand
+        template <typename NodeHandle>
+        struct HierarchicalPath
+        {
+            std::vector<NodeHandle> waypoints;
+            double cost = 0.0;
+
+            std::size_t segmentCount() const
+            {
+                return waypoints.size() < 2 ? 0 : waypoints.size() - 1;
+            }
+        };
+
+        /// Hierarchical path-finding (HPA*) over any Graph
+        /// clusterOf(graph, node) assigns every node to a cluster (for a grid, typically a square block of cells).
+        /// build() splits the border between each pair of neighboring clusters into runs (connected stretches of crossing edges) and places
+        /// transitions on them as in Botea et al.'s HPA*: one in the middle of a run shorter than maxSingleTransitionRun, one at each end of a
+        /// longer one. The nodes on either side of a transition are entrances. Two searches per entrance, restricted to its cluster, give
+        /// the costs between the entrances of a cluster and tables of the costs between every node and its cluster's entrances
+        /// (2 * entrances doubles per node), so linking a query's endpoints into the abstract graph is a table lookup.
+        /// findPath() searches the much smaller abstract graph of entrances; refineSegment() turns one leg into a concrete path only when it is needed.
+        /// Paths are near optimal (they bend through the transitions) but never missed: every run keeps at least one transition.
+        /// After edges change, rebuildCluster() / notifyEdgeChanged() recompute only the affected clusters.
+        /// The neighbor relation is assumed symmetric (if v is a neighbor of u, u is a neighbor of v) for border detection; costs may differ per direction
+        template <Graph GraphType, typename ClusterFn, CostFunction<GraphType> CostFn, CostFunction<GraphType> HeuristicFn>
+        class HierarchicalPathfinder
+        {
+        public:
+            using NodeHandle = typename GraphType::NodeHandle;
+            using ClusterId = std::uint32_t;
+            using View = ClusterView<GraphType, ClusterFn>;
+            using Abstract = AbstractGraph<NodeHandle>;
+            using Path = HierarchicalPath<NodeHandle>;
+
+            /// border runs up to this many crossings long get a single transition in the middle, longer ones one at each end
+            static constexpr std::size_t maxSingleTransitionRun = 6;
+
+            HierarchicalPathfinder(const GraphType& graph, ClusterFn clusterOf, CostFn costFunction, HeuristicFn heuristic)
+                : graph(graph), clusterOf(clusterOf), costFunction(costFunction), heuristic(heuristic)
+            {
+            }
+
+            /// builds the abstraction from scratch; nodes must list every node of the graph
+            void build(std::span<const NodeHandle> nodes)
+            {
+                clusters.clear();
+                nodeSlots.clear();
+
+                for (const NodeHandle& node : nodes)
+                {
+                    clusters[clusterIdOf(node)].members.push_back(node);
+
+                    if constexpr (!DenseIndexedGraph<GraphType>)
+                    {
+                        nodeSlots.emplace(node, std::uint32_t(nodeSlots.size()));
+                    }
+                }
+
+                costs.assign(DenseIndexedGraph<GraphType> ? graph.size() : nodes.size(), 0.0);
+                costStamps.assign(costs.size(), 0u);
+                costGeneration = 0;
+                memberIndex.assign(costs.size(), 0u);
+
+                for (auto& [id, cluster] : clusters)
+                {
+                    for (std::uint32_t m = 0; m < cluster.members.size(); ++m)
+                    {
+                        memberIndex[slotOf(cluster.members[m])] = m;
+                    }
+                }
+
+                for (auto& [id, cluster] : clusters)
+                {
+                    buildCluster(id, cluster);
+                }
+
+                assemble();
+            }
+
+            /// recomputes the entrances, intra-cluster costs and outgoing edges of one cluster, then relinks the abstract graph
+            void rebuildCluster(ClusterId id)
+            {
+                auto it = clusters.find(id);
+
+                if (it != clusters.end())
+                {
+                    buildCluster(id, it->second);
+                    assemble();
+                }
+            }
+
+            /// call when the cost of (or the existence of) the edge between u and v changed
+            /// Besides the clusters of u and v, the clusters bordering u or v are rebuilt too, since the change can move their shared transitions
+            void notifyEdgeChanged(const NodeHandle& u, const NodeHandle& v)
+            {
+                std::vector<ClusterId> affected = { clusterIdOf(u), clusterIdOf(v) };
+
+                for (const NodeHandle& node : { u, v })
+                {
+                    for (auto it = graph.neighbor_begin(node); it != graph.neighbor_end(node); ++it)
+                    {
+                        affected.push_back(clusterIdOf(*it));
+                    }
+                }
+
+                std::sort(affected.begin(), affected.end());
+                affected.erase(std::unique(affected.begin(), affected.end()), affected.end());
+
+                for (ClusterId id : affected)
+                {
+                    if (auto it = clusters.find(id); it != clusters.end())
+                    {
+                        buildCluster(id, it->second);
+                    }
+                }
+
+                assemble();
+            }
+
+            /// searches the abstract graph; on success out holds the waypoints from start to target
+            bool findPath(const NodeHandle& start, const NodeHandle& target, Path& out)
+            {
+                out.waypoints.clear();
+                out.cost = 0.0;
+
+                if (!graph.is_valid_handle(start) || !graph.is_valid_handle(target))
+                {
+                    return false;
+                }
+
+                if (start == target)
+                {
+                    out.waypoints.push_back(start);
+                    return true;
+                }
+
+                const std::size_t baseNodeCount = abstractGraph.nodes.size();
+                appendedEdges.clear();
+
+                const std::uint32_t s = insertEndpoint(start, true);
+                const std::uint32_t t = insertEndpoint(target, false);
+
+                const ClusterId startCluster = clusterIdOf(start);
+
+                if (startCluster == clusterIdOf(target))
+                {
+                    // the direct route inside the shared cluster may beat any route through its entrances
+                    View view(graph, clusterOf, startCluster);
+                    std::span<const NodeHandle> direct = AStar(viewContext, view, start, target, viewCost(), viewHeuristic());
+
+                    if (!direct.empty())
+                    {
+                        appendEdge(s, t, pathCost(direct));
+                    }
+                }
+
+                AbstractEdgeCost abstractCost;
+                auto abstractHeuristic = [this](const Abstract& g, std::uint32_t a, std::uint32_t b) { return double(heuristic(graph, g.nodes[a], g.nodes[b])); };
+
+                std::span<const std::uint32_t> abstractPath = AStar(abstractContext, abstractGraph, s, t, abstractCost, abstractHeuristic);
+
+                for (std::size_t i = 0; i < abstractPath.size(); ++i)
+                {
+                    out.waypoints.push_back(abstractGraph.nodes[abstractPath[i]]);
+
+                    if (i > 0)
+                    {
+                        out.cost += abstractGraph.edge_cost(abstractPath[i - 1], abstractPath[i]);
+                    }
+                }
+
+                // take the query's endpoints back out of the abstract graph
+                for (auto it = appendedEdges.rbegin(); it != appendedEdges.rend(); ++it)
+                {
+                    abstractGraph.edges[*it].pop_back();
+                }
+
+                abstractGraph.nodes.resize(baseNodeCount);
+                abstractGraph.edges.resize(baseNodeCount);
+
+                return !out.waypoints.empty();
+            }
+
+            /// concrete path for leg i of path (from waypoints[i] to waypoints[i + 1], both included)
+            /// the view is valid until the next call into the pathfinder
+            std::span<const NodeHandle> refineSegment(const Path& path, std::size_t i)
+            {
+                assert(i < path.segmentCount());
+
+                const NodeHandle& from = path.waypoints[i];
+                const NodeHandle& to = path.waypoints[i + 1];
+                const ClusterId cluster = clusterIdOf(from);
+
+                if (cluster != clusterIdOf(to))
+                {
+                    viewContext.path.assign({from, to});
+                    return viewContext.path;
+                }
+
+                View view(graph, clusterOf, cluster);
+                return AStar(viewContext, view, from, to, viewCost(), viewHeuristic());
+            }
+
+            /// refines every leg into one concrete path, start to target
+            void refineAll(const Path& path, std::vector<NodeHandle>& out)
+            {
+                out.clear();
+
+                if (path.segmentCount() == 0)
+                {
+                    out.assign(path.waypoints.begin(), path.waypoints.end());
+                    return;
+                }
+
+                for (std::size_t i = 0; i < path.segmentCount(); ++i)
+                {
+                    std::span<const NodeHandle> leg = refineSegment(path, i);
+                    out.insert(out.end(), leg.begin() + (out.empty() ? 0 : 1), leg.end());
+                }
+            }
+
+            std::size_t clusterCount() const
+            {
+                return clusters.size();
+            }
+
+            /// number of entrance nodes in the abstract graph
+            std::size_t abstractNodeCount() const
+            {
+                return abstractGraph.size();
+            }
+
+            const Abstract& abstraction() const
+            {
+                return abstractGraph;
+            }
+
+        private:
+
+            struct LocalEdge
+            {
+                std::uint32_t from;   ///< index into entrances
+                NodeHandle to;
+                double cost;
+            };
+
+            /// an edge from a node of the lower numbered cluster to one of the higher numbered cluster
+            struct Crossing
+            {
+                NodeHandle low;
+                NodeHandle high;
+            };
+
+            struct BorderCrossing
+            {
+                ClusterId other;
+                std::size_t lowSlot;
+                std::size_t highSlot;
+                Crossing crossing;
+            };
+
+            struct CostEntry
+            {
+                double cost;
+                NodeHandle node;
+            };
+
+            struct Cluster
+            {
+                std::vector<NodeHandle> members;
+                std::vector<NodeHandle> entrances;
+                std::vector<LocalEdge> edges; ///< intra-cluster edges between entrances and edges that cross into neighboring clusters
+                std::vector<double> fromEntrance; ///< cost from entrance e to member m, at [m * entrances.size() + e] (largest double if unreachable)
+                std::vector<double> toEntrance;   ///< cost from member m to entrance e, same layout
+            };
+
+            ClusterId clusterIdOf(const NodeHandle& node) const
+            {
+                return ClusterId(clusterOf(graph, node));
+            }
+
+            auto viewCost() const
+            {
+                return [this](const View& view, const NodeHandle& a, const NodeHandle& b) { return double(costFunction(view.base(), a, b)); };
+            }
+
+            auto viewHeuristic() const
+            {
+                return [this](const View& view, const NodeHandle& a, const NodeHandle& b) { return double(heuristic(view.base(), a, b)); };
+            }
+
+            template <typename PathSpan>
+            double pathCost(const PathSpan& path) const
+            {
+                double cost = 0.0;
+
+                for (std::size_t i = 1; i < path.size(); ++i)
+                {
+                    cost += costFunction(graph, path[i - 1], path[i]);
+                }
+
+                return cost;
+            }
+
+            bool adjacent(const NodeHandle& a, const NodeHandle& b) const
+            {
+                for (auto it = graph.neighbor_begin(a); it != graph.neighbor_end(a); ++it)
+                {
+                    if (*it == b)
+                    {
+                        return true;
+                    }
+                }
+
+                return false;
+            }
+
+            /// Picks the transitions among the crossings of the border between two clusters. Two crossings belong to the same run when their
+            /// nodes are the same or neighbors on both sides; each run gets its transitions at the middle or the ends of its longest stretch
+            /// (found with two breadth first searches). The result only depends on the graph and the order of crossings
+            void borderTransitions(std::span<const Crossing> crossings, std::vector<Crossing>& out)
+            {
+                out.clear();
+
+                const std::uint32_t count = std::uint32_t(crossings.size());
+
+                crossingsByLow.clear();
+
+                for (std::uint32_t i = 0; i < count; ++i)
+                {
+                    crossingsByLow[crossings[i].low].push_back(i);
+                }
+
+                auto forEachAdjacent = [&](std::uint32_t c, auto&& f)
+                {
+                    const Crossing& crossing = crossings[c];
+
+                    auto visit = [&](const NodeHandle& low)
+                    {
+                        auto it = crossingsByLow.find(low);
+
+                        if (it == crossingsByLow.end())
+                        {
+                            return;
+                        }
+
+                        for (std::uint32_t other : it->second)
+                        {
+                            const NodeHandle& high = crossings[other].high;
+
+                            if (other != c && (high == crossing.high || adjacent(crossing.high, high)))
+                            {
+                                f(other);
+                            }
+                        }
+                    };
+
+                    visit(crossing.low);
+
+                    for (auto it = graph.neighbor_begin(crossing.low); it != graph.neighbor_end(crossing.low); ++it)
+                    {
+                        visit(*it);
+                    }
+                };
+
+                runSeen.assign(count, 0);
+                runParent.resize(count);
+                std::vector<bool> assigned(count, false);
+                std::uint32_t epoch = 0;
+
+                // breadth first search over the run holding from; leaves the run in runQueue and returns the crossing found last (the farthest)
+                auto search = [&](std::uint32_t from)
+                {
+                    ++epoch;
+                    runQueue.assign(1, from);
+                    runSeen[from] = epoch;
+                    runParent[from] = from;
+
+                    for (std::size_t i = 0; i < runQueue.size(); ++i)
+                    {
+                        const std::uint32_t c = runQueue[i];
+
+                        forEachAdjacent(c, [&](std::uint32_t other)
+                        {
+                            if (runSeen[other] != epoch)
+                            {
+                                runSeen[other] = epoch;
+                                runParent[other] = c;
+                                runQueue.push_back(other);
+                            }
+                        });
+                    }
+
+                    return runQueue.back();
+                };
+
+                for (std::uint32_t first = 0; first < count; ++first)
+                {
+                    if (assigned[first])
+                    {
+                        continue;
+                    }
+
+                    const std::uint32_t a = search(first);
+
+                    for (std::uint32_t c : runQueue)
+                    {
+                        assigned[c] = true;
+                    }
+
+                    const std::uint32_t b = search(a);
+
+                    runPath.clear();
+
+                    for (std::uint32_t c = b; ; c = runParent[c])
+                    {
+                        runPath.push_back(c);
+
+                        if (c == a)
+                        {
+                            break;
+                        }
+                    }
+
+                    if (runPath.size() <= maxSingleTransitionRun)
+                    {
+                        out.push_back(crossings[runPath[runPath.size() / 2]]);
+                    }
+                    else
+                    {
+                        out.push_back(crossings[runPath.front()]);
+                        out.push_back(crossings[runPath.back()]);
+                    }
+                }
+            }
+
+            void buildCluster(ClusterId id, Cluster& cluster)
+            {
+                cluster.entrances.clear();
+                cluster.edges.clear();
+
+                // every crossing out of the cluster, sorted by neighboring cluster and then by node slots, so that the clusters on either side
+                // of a border see its crossings in the same order and agree on the transitions
+                borderScratch.clear();
+
+                for (const NodeHandle& node : cluster.members)
+                {
+                    for (auto it = graph.neighbor_begin(node); it != graph.neighbor_end(node); ++it)
+                    {
+                        if (const ClusterId other = clusterIdOf(*it); other != id)
+                        {
+                            const Crossing crossing = id < other ? Crossing{node, *it} : Crossing{*it, node};
+                            borderScratch.push_back({other, slotOf(crossing.low), slotOf(crossing.high), crossing});
+                        }
+                    }
+                }
+
+                std::sort(borderScratch.begin(), borderScratch.end(), [](const BorderCrossing& a, const BorderCrossing& b)
+                {
+                    return std::tie(a.other, a.lowSlot, a.highSlot) < std::tie(b.other, b.lowSlot, b.highSlot);
+                });
+
+                std::vector<Crossing> transitions;
+
+                for (std::size_t first = 0; first < borderScratch.size(); )
+                {
+                    const ClusterId other = borderScratch[first].other;
+                    std::size_t last = first;
+
+                    crossings.clear();
+
+                    for (; last < borderScratch.size() && borderScratch[last].other == other; ++last)
+                    {
+                        crossings.push_back(borderScratch[last].crossing);
+                    }
+
+                    first = last;
+                    borderTransitions(crossings, transitions);
+
+                    for (const Crossing& transition : transitions)
+                    {
+                        const NodeHandle& mine = id < other ? transition.low : transition.high;
+                        const NodeHandle& theirs = id < other ? transition.high : transition.low;
+
+                        auto entrance = std::find(cluster.entrances.begin(), cluster.entrances.end(), mine);
+
+                        if (entrance == cluster.entrances.end())
+                        {
+                            entrance = cluster.entrances.insert(entrance, mine);
+                        }
+
+                        cluster.edges.push_back({std::uint32_t(entrance - cluster.entrances.begin()), theirs, double(costFunction(graph, mine, theirs))});
+                    }
+                }
+
+                // a search out of each entrance gives its costs to the other entrances and to every member; a reversed one the members' costs to it
+                const std::size_t entranceCount = cluster.entrances.size();
+                cluster.fromEntrance.assign(cluster.members.size() * entranceCount, 0.0);
+                cluster.toEntrance.assign(cluster.members.size() * entranceCount, 0.0);
+
+                for (std::uint32_t a = 0; a < entranceCount; ++a)
+                {
+                    clusterCosts(id, cluster.entrances[a], false);
+
+                    for (std::uint32_t b = 0; b < entranceCount; ++b)
+                    {
+                        const double cost = reachedCost(cluster.entrances[b]);
+
+                        if (a != b && cost < std::numeric_limits<double>::max())
+                        {
+                            cluster.edges.push_back({a, cluster.entrances[b], cost});
+                        }
+                    }
+
+                    for (std::size_t m = 0; m < cluster.members.size(); ++m)
+                    {
+                        cluster.fromEntrance[m * entranceCount + a] = reachedCost(cluster.members[m]);
+                    }
+
+                    clusterCosts(id, cluster.entrances[a], true);
+
+                    for (std::size_t m = 0; m < cluster.members.size(); ++m)
+                    {
+                        cluster.toEntrance[m * entranceCount + a] = reachedCost(cluster.members[m]);
+                    }
+                }
+            }
+
+            std::size_t slotOf(const NodeHandle& node) const
+            {
+                if constexpr (DenseIndexedGraph<GraphType>)
+                {
+                    return graph.index_of(node);
+                }
+                else
+                {
+                    return nodeSlots.find(node)->second;
+                }
+            }
+
+            /// Cost of the cheapest path from source to every node of cluster id that stays inside the cluster (Dijkstra; reversed walks edges
+            /// backwards and gives the cost from every node to source). Results are read with reachedCost() until the next call
+            void clusterCosts(ClusterId id, const NodeHandle& source, bool reversed)
+            {
+                if (++costGeneration == 0)
+                {
+                    std::fill(costStamps.begin(), costStamps.end(), 0u);
+                    costGeneration = 1;
+                }
+
+                View view(graph, clusterOf, id);
+                auto later = [](const CostEntry& a, const CostEntry& b) { return a.cost > b.cost; };
+
+                const std::size_t sourceSlot = slotOf(source);
+                costs[sourceSlot] = 0.0;
+                costStamps[sourceSlot] = costGeneration;
+                costHeap.assign(1, {0.0, source});
+
+                while (!costHeap.empty())
+                {
+                    std::pop_heap(costHeap.begin(), costHeap.end(), later);
+                    const CostEntry entry = costHeap.back();
+                    costHeap.pop_back();
+
+                    if (entry.cost > costs[slotOf(entry.node)])
+                    {
+                        continue; // superseded by a cheaper entry
+                    }
+
+                    for (auto it = view.neighbor_begin(entry.node); it != view.neighbor_end(entry.node); ++it)
+                    {
+                        const NodeHandle next = *it;
+                        const double cost = entry.cost + double(reversed ? costFunction(graph, next, entry.node) : costFunction(graph, entry.node, next));
+                        const std::size_t slot = slotOf(next);
+
+                        if (costStamps[slot] != costGeneration || cost < costs[slot])
+                        {
+                            costs[slot] = cost;
+                            costStamps[slot] = costGeneration;
+                            costHeap.push_back({cost, next});
+                            std::push_heap(costHeap.begin(), costHeap.end(), later);
+                        }
+                    }
+                }
+            }
+
+            /// cost found for node by the last clusterCosts(), or the largest double if it wasn't reached
+            double reachedCost(const NodeHandle& node) const
+            {
+                const std::size_t slot = slotOf(node);
+                return costStamps[slot] == costGeneration ? costs[slot] : std::numeric_limits<double>::max();
+            }
+
+            /// relinks the abstract graph from the per cluster entrances and edges; no searches are run here
+            void assemble()
+            {
+                abstractGraph.nodes.clear();
+                abstractGraph.edges.clear();
+                entranceIds.clear();
+
+                for (auto& [id, cluster] : clusters)
+                {
+                    for (const NodeHandle& e : cluster.entrances)
+                    {
+                        entranceIds[e] = std::uint32_t(abstractGraph.nodes.size());
+                        abstractGraph.nodes.push_back(e);
+                    }
+                }
+
+                abstractGraph.edges.resize(abstractGraph.nodes.size());
+
+                for (auto& [id, cluster] : clusters)
+                {
+                    for (const LocalEdge& edge : cluster.edges)
+                    {
+                        auto to = entranceIds.find(edge.to);
+
+                        if (to != entranceIds.end())
+                        {
+                            abstractGraph.edges[entranceIds[cluster.entrances[edge.from]]].push_back({to->second, edge.cost});
+                        }
+                    }
+                }
+            }
+
+            void appendEdge(std::uint32_t from, std::uint32_t to, double cost)
+            {
+                abstractGraph.edges[from].push_back({to, cost});
+                appendedEdges.push_back(from);
+            }
+
+            /// adds a query endpoint to the abstract graph, linked to the entrances of its cluster (reuses the entrance node if it is one)
+            std::uint32_t insertEndpoint(const NodeHandle& node, bool outgoing)
+            {
+                if (auto it = entranceIds.find(node); it != entranceIds.end())
+                {
+                    return it->second;
+                }
+
+                const std::uint32_t id = std::uint32_t(abstractGraph.nodes.size());
+                abstractGraph.nodes.push_back(node);
+                abstractGraph.edges.emplace_back();
+
+                const ClusterId clusterId = clusterIdOf(node);
+                auto cluster = clusters.find(clusterId);
+
+                if (cluster == clusters.end())
+                {
+                    return id;
+                }
+
+                // the costs between the endpoint and its cluster's entrances were tabulated by buildCluster
+                const Cluster& c = cluster->second;
+                const std::size_t row = memberIndex[slotOf(node)] * c.entrances.size();
+                const std::vector<double>& table = outgoing ? c.toEntrance : c.fromEntrance;
+
+                for (std::size_t e = 0; e < c.entrances.size(); ++e)
+                {
+                    const double cost = table[row + e];
+
+                    if (cost < std::numeric_limits<double>::max())
+                    {
+                        const std::uint32_t entrance = entranceIds[c.entrances[e]];
+
+                        if (outgoing)
+                        {
+                            appendEdge(id, entrance, cost);
+                        }
+                        else
+                        {
+                            appendEdge(entrance, id, cost);
+                        }
+                    }
+                }
+
+                return id;
+            }
+
+            const GraphType& graph;
+            ClusterFn clusterOf;
+            CostFn costFunction;
+            HeuristicFn heuristic;
+
+            std::unordered_map<ClusterId, Cluster> clusters;
+            std::unordered_map<NodeHandle, std::uint32_t> entranceIds;
+            Abstract abstractGraph;
+            std::vector<std::uint32_t> appendedEdges;
+
+            // scratch for clusterCosts: costs and costStamps are indexed by slotOf(), an entry is current if its stamp is costGeneration
+            std::unordered_map<NodeHandle, std::uint32_t> nodeSlots; ///< slot of each node, for graphs that aren't DenseIndexedGraph
+            std::vector<double> costs;
+            std::vector<std::uint32_t> costStamps;
+            std::uint32_t costGeneration = 0;
+            std::vector<CostEntry> costHeap;
+            std::vector<std::uint32_t> memberIndex; ///< position of each node in its cluster's members, by slot
+
+            // scratch for buildCluster / borderTransitions
+            std::vector<BorderCrossing> borderScratch;
+            std::vector<Crossing> crossings;
+            std::unordered_map<NodeHandle, std::vector<std::uint32_t>> crossingsByLow;
+            std::vector<std::uint32_t> runSeen;
+            std::vector<std::uint32_t> runParent;
+            std::vector<std::uint32_t> runQueue;
+            std::vector<std::uint32_t> runPath;
+
+            AStarContext<View> viewContext;
+            AStarContext<Abstract> abstractContext;
+        };
+    }
+}
@@ -0,0 +1,472 @@
+#pragma once
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "AStar.h"
+#include "GridGraph.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// Precomputed jump distances for JPS+ (one entry per cell per direction, directions as in GridGraph::directionX/Y)
+        /// A positive entry is the number of steps to the next jump point in that direction,
+        /// zero or a negative entry is minus the number of steps that can be taken before hitting a wall
+        /// Rebuild whenever the grid's walkable flags change
+        class JumpPointTable
+        {
+        public:
+            JumpPointTable() = default;
+
+            explicit JumpPointTable(const GridGraph& grid)
+            {
+                rebuild(grid);
+            }
+
+            void rebuild(const GridGraph& grid);
+
+            std::int32_t distance(GridGraph::NodeHandle node, int direction) const
+            {
+                return distances[node][direction];
+            }
+
+            std::size_t size() const
+            {
+                return distances.size();
+            }
+
+        private:
+            std::vector<std::array<std::int32_t, 8> > distances;
+        };
+
+        namespace detail
+        {
+            inline int sign(int v)
+            {
+                return (v > 0) - (v < 0);
+            }
+
+            inline int gridDirectionIndex(int dx, int dy)
+            {
+                for (int d = 0; d < 8; ++d)
+                {
+                    if (GridGraph::directionX[d] == dx && GridGraph::directionY[d] == dy)
+                    {
+                        return d;
+                    }
+                }
+
+                return -1;
+            }
+
+            /// true if (x, y) is a jump point for a straight move along dx / dy: an orthogonal neighbor is open but was blocked one step back
+            inline bool isStraightJumpPoint(const GridGraph& grid, int x, int y, int dx, int dy)
+            {
+                if (dx != 0)
+                {
+                    return (grid.is_walkable(x, y + 1) && !grid.is_walkable(x - dx, y + 1)) ||
+                           (grid.is_walkable(x, y - 1) && !grid.is_walkable(x - dx, y - 1));
+                }
+
+                return (grid.is_walkable(x + 1, y) && !grid.is_walkable(x + 1, y - dy)) ||
+                       (grid.is_walkable(x - 1, y) && !grid.is_walkable(x - 1, y - dy));
+            }
+
+            /// calls visit(dx, dy) for every direction worth searching from (x, y) when it was reached from (px, py)
+            /// with no parent (the start node) every legal move is searched
+            template <typename Visitor>
+            void forEachJumpDirection(const GridGraph& grid, int x, int y, int px, int py, bool hasParent, Visitor visit)
+            {
+                if (!hasParent)
+                {
+                    for (int d = 0; d < 8; ++d)
+                    {
+                        if (grid.can_step(x, y, GridGraph::directionX[d], GridGraph::directionY[d]))
+                        {
+                            visit(GridGraph::directionX[d], GridGraph::directionY[d]);
+                        }
+                    }
+
+                    return;
+                }
+
+                const int dx = sign(x - px);
+                const int dy = sign(y - py);
+
+                if (dx != 0 && dy != 0)
+                {
+                    const bool vertical = grid.is_walkable(x, y + dy);
+                    const bool horizontal = grid.is_walkable(x + dx, y);
+
+                    if (vertical) visit(0, dy);
+                    if (horizontal) visit(dx, 0);
+                    if (vertical && horizontal && grid.is_walkable(x + dx, y + dy)) visit(dx, dy);
+                }
+                else if (dx != 0)
+                {
+                    const bool next = grid.is_walkable(x + dx, y);
+                    const bool up = grid.is_walkable(x, y + 1);
+                    const bool down = grid.is_walkable(x, y - 1);
+
+                    if (next)
+                    {
+                        visit(dx, 0);
+                        if (up && grid.is_walkable(x + dx, y + 1)) visit(dx, 1);
+                        if (down && grid.is_walkable(x + dx, y - 1)) visit(dx, -1);
+                    }
+
+                    if (up) visit(0, 1);
+                    if (down) visit(0, -1);
+                }
+                else
+                {
+                    const bool next = grid.is_walkable(x, y + dy);
+                    const bool right = grid.is_walkable(x + 1, y);
+                    const bool left = grid.is_walkable(x - 1, y);
+
+                    if (next)
+                    {
+                        visit(0, dy);
+                        if (right && grid.is_walkable(x + 1, y + dy)) visit(1, dy);
+                        if (left && grid.is_walkable(x - 1, y + dy)) visit(-1, dy);
+                    }
+
+                    if (right) visit(1, 0);
+                    if (left) visit(-1, 0);
+                }
+            }
+
+            constexpr GridGraph::NodeHandle noJumpPoint = ~GridGraph::NodeHandle(0);
+
+            /// online jump: scans from (x, y) along (dx, dy) and returns the first jump point (or target), noJumpPoint if a wall is hit first
+            inline GridGraph::NodeHandle jump(const GridGraph& grid, int x, int y, int dx, int dy, int tx, int ty)
+            {
+                for (;;)
+                {
+                    if (!grid.can_step(x, y, dx, dy))
+                    {
+                        return noJumpPoint;
+                    }
+
+                    x += dx;
+                    y += dy;
+
+                    if (x == tx && y == ty)
+                    {
+                        return grid.handle_of(x, y);
+                    }
+
+                    if (dx != 0 && dy != 0)
+                    {
+                        if (jump(grid, x, y, dx, 0, tx, ty) != noJumpPoint || jump(grid, x, y, 0, dy, tx, ty) != noJumpPoint)
+                        {
+                            return grid.handle_of(x, y);
+                        }
+                    }
+                    else if (isStraightJumpPoint(grid, x, y, dx, dy))
+                    {
+                        return grid.handle_of(x, y);
+                    }
+                }
+            }
+
+            /// JPS+ jump: looks the jump distance up in the table; if the target lies on the way, returns it (or, on a diagonal, the node lined up with it)
+            inline GridGraph::NodeHandle jump(const GridGraph& grid, const JumpPointTable& table, int x, int y, int dx, int dy, int tx, int ty)
+            {
+                const std::int32_t distance = table.distance(grid.handle_of(x, y), gridDirectionIndex(dx, dy));
+                const int reach = distance < 0 ? -distance : distance;
+                const int toTargetX = tx - x;
+                const int toTargetY = ty - y;
+
+                if (dx == 0 || dy == 0)
+                {
+                    const int along = dx != 0 ? toTargetX : toTargetY;
+                    const int across = dx != 0 ? toTargetY : toTargetX;
+
+                    if (across == 0 && sign(along) == dx + dy && std::abs(along) <= reach)
+                    {
+                        return grid.handle_of(tx, ty);
+                    }
+                }
+                else if (sign(toTargetX) == dx && sign(toTargetY) == dy)
+                {
+                    const int steps = std::min(std::abs(toTargetX), std::abs(toTargetY));
+
+                    if (steps <= reach)
+                    {
+                        return grid.handle_of(x + steps * dx, y + steps * dy);
+                    }
+                }
+
+                return distance > 0 ? grid.handle_of(x + distance * dx, y + distance * dy) : noJumpPoint;
+            }
+
+            /// A* over jump points; jumpFn(x, y, dx, dy) returns the next jump point in a direction or noJumpPoint
+            /// On success context.path holds every cell from start to target (jump points joined by their straight or diagonal runs)
+            template <typename Records, typename OpenList, typename JumpFn>
+            std::span<const GridGraph::NodeHandle> JumpPointSearch(
+                AStarContext<GridGraph, Records, OpenList>& context,
+                const GridGraph& grid,
+                GridGraph::NodeHandle start,
+                GridGraph::NodeHandle target,
+                JumpFn jumpFn
+                )
+            {
+                using NodeHandle = GridGraph::NodeHandle;
+
+                GridOctileDistance distance;
+                Records& records = context.records;
+                OpenList& frontier = context.frontier;
+
+                context.path.clear();
+                context.stats.reset();
+
+                if (!grid.is_valid_handle(start) || !grid.is_valid_handle(target) || !grid[start] || !grid[target])
+                {
+                    return {};
+                }
+
+                if (start == target)
+                {
+                    context.path.push_back(start);
+                    return context.path;
+                }
+
+                AStarBegin(records, frontier, grid, start, target, distance, context.stats);
+
+                while (!frontier.empty())
+                {
+                    const NodeHandle node = frontier.pop().node;
+
+                    if (node == target)
+                    {
+                        // gather the jump points start to target, then fill in the cells between them back to front
+                        AStarTracePath(records, grid, target, [&](const NodeHandle& n) { context.path.push_back(n); });
+                        std::reverse(context.path.begin(), context.path.end());
+
+                        std::size_t cellCount = 1;
+                        for (std::size_t i = 1; i < context.path.size(); ++i)
+                        {
+                            const NodeHandle a = context.path[i - 1];
+                            const NodeHandle b = context.path[i];
+                            cellCount += std::max(std::abs(grid.x_of(b) - grid.x_of(a)), std::abs(grid.y_of(b) - grid.y_of(a)));
+                        }
+
+                        std::size_t jumpPoints = context.path.size();
+                        context.path.resize(cellCount);
+
+                        std::size_t write = cellCount - 1;
+                        context.path[write] = context.path[jumpPoints - 1];
+
+                        for (std::size_t i = jumpPoints - 1; i > 0; --i)
+                        {
+                            const NodeHandle from = context.path[i - 1];
+                            const NodeHandle to = context.path[i];
+                            const int sx = sign(grid.x_of(from) - grid.x_of(to));
+                            const int sy = sign(grid.y_of(from) - grid.y_of(to));
+                            int x = grid.x_of(to);
+                            int y = grid.y_of(to);
+
+                            while (grid.handle_of(x, y) != from)
+                            {
+                                x += sx;
+                                y += sy;
+                                context.path[--write] = grid.handle_of(x, y);
+                            }
+                        }
+
+                        return context.path;
+                    }
+
+                    const auto key = records.key(grid, node);
+
+                    if (records.closed(key))
+                    {
+                        ++context.stats.duplicatePops;
+                        continue;
+                    }
+
+                    records.close(key);
+                    ++context.stats.expansions;
+
+                    const double costSoFar = records.cost(key);
+                    const NodeHandle parent = records.parent(key);
+                    const int x = grid.x_of(node);
+                    const int y = grid.y_of(node);
+
+                    forEachJumpDirection(grid, x, y, grid.x_of(parent), grid.y_of(parent), parent != node, [&](int dx, int dy)
+                    {
+                        const NodeHandle jumpPoint = jumpFn(x, y, dx, dy);
+
+                        if (jumpPoint == noJumpPoint)
+                        {
+                            return;
+                        }
+
+                        auto n = records.key(grid, jumpPoint);
+                        const double proposedCost = costSoFar + distance(grid, node, jumpPoint);
+
+                        if (!records.touched(n))
+                        {
+                            const double h = distance(grid, jumpPoint, target);
+                            ++context.stats.heuristicCalls;
+
+                            records.touch(n, node, proposedCost, h);
+                            frontier.push(grid, jumpPoint, proposedCost + h);
+                            ++context.stats.pushes;
+                        }
+                        else if (proposedCost < records.cost(n))
+                        {
+                            records.parent(n) = node;
+                            records.cost(n) = proposedCost;
+                            records.reopen(n);
+                            frontier.push(grid, jumpPoint, proposedCost + records.heuristic(n));
+                            ++context.stats.pushes;
+                        }
+                    });
+                }
+
+                return {};
+            }
+        }
+
+        inline void JumpPointTable::rebuild(const GridGraph& grid)
+        {
+            const int width = int(grid.width());
+            const int height = int(grid.height());
+
+            distances.assign(grid.size(), {});
+
+            // straight directions first; each entry only depends on the next cell along the same direction
+            for (int d = 0; d < 4; ++d)
+            {
+                const int dx = GridGraph::directionX[d];
+                const int dy = GridGraph::directionY[d];
+
+                for (int j = 0; j < height; ++j)
+                {
+                    for (int i = 0; i < width; ++i)
+                    {
+                        const int x = dx > 0 ? width - 1 - i : i;
+                        const int y = dy > 0 ? height - 1 - j : j;
+                        std::int32_t& entry = distances[grid.handle_of(x, y)][d];
+
+                        if (!grid.can_step(x, y, dx, dy))
+                        {
+                            entry = 0;
+                        }
+                        else if (detail::isStraightJumpPoint(grid, x + dx, y + dy, dx, dy))
+                        {
+                            entry = 1;
+                        }
+                        else
+                        {
+                            const std::int32_t next = distances[grid.handle_of(x + dx, y + dy)][d];
+                            entry = next > 0 ? next + 1 : next - 1;
+                        }
+                    }
+                }
+            }
+
+            // diagonals stop wherever one of their straight components sees a jump point
+            for (int d = 4; d < 8; ++d)
+            {
+                const int dx = GridGraph::directionX[d];
+                const int dy = GridGraph::directionY[d];
+                const int horizontal = detail::gridDirectionIndex(dx, 0);
+                const int vertical = detail::gridDirectionIndex(0, dy);
+
+                for (int j = 0; j < height; ++j)
+                {
+                    for (int i = 0; i < width; ++i)
+                    {
+                        const int x = dx > 0 ? width - 1 - i : i;
+                        const int y = dy > 0 ? height - 1 - j : j;
+                        std::int32_t& entry = distances[grid.handle_of(x, y)][d];
+
+                        if (!grid.can_step(x, y, dx, dy))
+                        {
+                            entry = 0;
+                            continue;
+                        }
+
+                        const auto& next = distances[grid.handle_of(x + dx, y + dy)];
+
+                        if (next[horizontal] > 0 || next[vertical] > 0)
+                        {
+                            entry = 1;
+                        }
+                        else
+                        {
+                            entry = next[d] > 0 ? next[d] + 1 : next[d] - 1;
+                        }
+                    }
+                }
+            }
+        }
+
+        /// Jump Point Search on a GridGraph: A* that skips over runs of symmetric cells and only expands jump points
+        /// Returns the same cell by cell path (start to target, in context.path) as AStar() with GridOctileDistance for cost and heuristic would, at equal cost
+        template <typename Records, typename OpenList>
+        std::span<const GridGraph::NodeHandle> JumpPointSearch(
+            AStarContext<GridGraph, Records, OpenList>& context,
+            const GridGraph& grid,
+            GridGraph::NodeHandle start,
+            GridGraph::NodeHandle target
+            )
+        {
+            const int tx = grid.x_of(target);
+            const int ty = grid.y_of(target);
+
+            return detail::JumpPointSearch(context, grid, start, target, [&](int x, int y, int dx, int dy)
+            {
+                return detail::jump(grid, x, y, dx, dy, tx, ty);
+            });
+        }
+
+        /// JPS+: Jump Point Search with the jump scans replaced by lookups into a JumpPointTable built from the same grid
+        template <typename Records, typename OpenList>
+        std::span<const GridGraph::NodeHandle> JumpPointSearch(
+            AStarContext<GridGraph, Records, OpenList>& context,
+            const GridGraph& grid,
+            const JumpPointTable& table,
+            GridGraph::NodeHandle start,
+            GridGraph::NodeHandle target
+            )
+        {
+            assert(table.size() == grid.size());
+
+            const int tx = grid.x_of(target);
+            const int ty = grid.y_of(target);
+
+            return detail::JumpPointSearch(context, grid, start, target, [&](int x, int y, int dx, int dy)
+            {
+                return detail::jump(grid, table, x, y, dx, dy, tx, ty);
+            });
+        }
+
+        /// Jump Point Search with the same std::stack result as AStar()
+        inline AStarResult<GridGraph::NodeHandle> JumpPointSearch(const GridGraph& grid, GridGraph::NodeHandle start, GridGraph::NodeHandle target)
+        {
+            AStarResult<GridGraph::NodeHandle> solution;
+
+            if (start == target)
+            {
+                return solution; // matches AStar(), which returns an empty path when start == target
+            }
+
+            AStarContext<GridGraph, MapTraversalRecords<GridGraph> > context;
+            std::span<const GridGraph::NodeHandle> path = JumpPointSearch(context, grid, start, target);
+
+            for (auto it = path.rbegin(); it != path.rend(); ++it)
+            {
+                solution.push(*it);
+            }
+
+            return solution;
+        }
+    }
+}
@@ -0,0 +1,508 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#if defined(_WIN32)
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "CSRGraph.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// On disk navgraph format: a CSR graph laid out so it can be mapped into memory and searched in place
+        ///
+        ///     [NavGraphFileHeader, 128 bytes][node payloads][offsets][neighbors][edge costs (optional)]
+        ///
+        /// Every section starts on a 64 byte boundary (and the mapping itself is page aligned), so the arrays are properly aligned for their types
+        /// and never share a cache line. Data is stored in the native byte order of the writer; the header records it and the loader rejects a mismatch.
+        /// The checksum is 64 bit FNV-1a over everything after the header.
+        struct NavGraphFileHeader
+        {
+            static constexpr char magicValue[8] = { 'V', 'N', 'A', 'V', 'G', 'R', 'P', 'H' };
+            static constexpr std::uint32_t currentVersion = 1;
+            static constexpr std::uint32_t byteOrderMark = 0x01020304u;
+            static constexpr std::size_t sectionAlignment = 64;
+
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t byteOrder;
+            std::uint32_t nodeSize;     ///< sizeof(NodeType) of the writer, checked against the loader's types
+            std::uint32_t indexSize;
+            std::uint32_t edgeCostSize;
+            std::uint32_t reserved0;
+            std::uint64_t nodeCount;
+            std::uint64_t edgeCount;
+            std::uint64_t nodesOffset;  ///< byte offsets of the sections from the start of the file
+            std::uint64_t offsetsOffset;
+            std::uint64_t neighborsOffset;
+            std::uint64_t edgeCostsOffset; ///< 0 if the graph has no edge costs
+            std::uint64_t fileSize;
+            std::uint64_t checksum;
+            std::uint8_t reserved[128 - 96];
+        };
+
+        static_assert(sizeof(NavGraphFileHeader) == 128, "navgraph header layout changed");
+        static_assert(std::is_trivially_copyable_v<NavGraphFileHeader>);
+
+        enum class NavGraphFileStatus
+        {
+            Ok,
+            OpenFailed,
+            MapFailed,
+            WriteFailed,
+            Truncated,
+            BadMagic,
+            VersionMismatch,
+            LayoutMismatch,  ///< byte order or element sizes differ from what the loader was instantiated with
+            ChecksumMismatch,
+            Corrupt          ///< counts out of range for the index type, or row offsets / neighbor indices pointing outside the graph
+        };
+
+        namespace detail
+        {
+            constexpr std::uint64_t fnv1aOffsetBasis = 14695981039346656037ull;
+            constexpr std::uint64_t fnv1aPrime = 1099511628211ull;
+
+            inline std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash = fnv1aOffsetBasis)
+            {
+                const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    hash = (hash ^ bytes[i]) * fnv1aPrime;
+                }
+
+                return hash;
+            }
+
+            inline std::uint64_t alignUp(std::uint64_t offset, std::uint64_t alignment)
+            {
+                return (offset + alignment - 1) / alignment * alignment;
+            }
+
+            /// read only mapping of a whole file; unmapped on destruction
+            class MappedFile
+            {
+            public:
+                MappedFile() = default;
+                MappedFile(const MappedFile&) = delete;
+                MappedFile& operator=(const MappedFile&) = delete;
+
+                MappedFile(MappedFile&& other) noexcept
+                {
+                    swap(other);
+                }
+
+                MappedFile& operator=(MappedFile&& other) noexcept
+                {
+                    if (this != &other)
+                    {
+                        close();
+                        swap(other);
+                    }
+
+                    return *this;
+                }
+
+                ~MappedFile()
+                {
+                    close();
+                }
+
+                NavGraphFileStatus open(const char* path)
+                {
+                    close();
+
+#if defined(_WIN32)
+                    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+                    if (file == INVALID_HANDLE_VALUE)
+                    {
+                        return NavGraphFileStatus::OpenFailed;
+                    }
+
+                    LARGE_INTEGER fileSize = {};
+
+                    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+                    {
+                        close();
+                        return fileSize.QuadPart == 0 ? NavGraphFileStatus::Truncated : NavGraphFileStatus::OpenFailed;
+                    }
+
+                    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                    data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+                    if (!data)
+                    {
+                        close();
+                        return NavGraphFileStatus::MapFailed;
+                    }
+
+                    size = std::size_t(fileSize.QuadPart);
+#else
+                    const int fd = ::open(path, O_RDONLY);
+
+                    if (fd < 0)
+                    {
+                        return NavGraphFileStatus::OpenFailed;
+                    }
+
+                    struct stat info = {};
+
+                    if (fstat(fd, &info) != 0 || info.st_size == 0)
+                    {
+                        const bool empty = info.st_size == 0;
+                        ::close(fd);
+                        return empty ? NavGraphFileStatus::Truncated : NavGraphFileStatus::OpenFailed;
+                    }
+
+                    void* mapped = mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+                    ::close(fd); // the mapping keeps the file alive
+
+                    if (mapped == MAP_FAILED)
+                    {
+                        return NavGraphFileStatus::MapFailed;
+                    }
+
+                    data = mapped;
+                    size = std::size_t(info.st_size);
+#endif
+                    return NavGraphFileStatus::Ok;
+                }
+
+                void close()
+                {
+#if defined(_WIN32)
+                    if (data)
+                    {
+                        UnmapViewOfFile(data);
+                    }
+
+                    if (mapping)
+                    {
+                        CloseHandle(mapping);
+                    }
+
+                    if (file != INVALID_HANDLE_VALUE)
+                    {
+                        CloseHandle(file);
+                    }
+
+                    mapping = nullptr;
+                    file = INVALID_HANDLE_VALUE;
+#else
+                    if (data)
+                    {
+                        munmap(data, size);
+                    }
+#endif
+                    data = nullptr;
+                    size = 0;
+                }
+
+                const unsigned char* bytes() const { return static_cast<const unsigned char*>(data); }
+                std::size_t byteSize() const { return size; }
+
+            private:
+
+                void swap(MappedFile& other) noexcept
+                {
+                    std::swap(data, other.data);
+                    std::swap(size, other.size);
+#if defined(_WIN32)
+                    std::swap(file, other.file);
+                    std::swap(mapping, other.mapping);
+#endif
+                }
+
+                void* data = nullptr;
+                std::size_t size = 0;
+#if defined(_WIN32)
+                HANDLE file = INVALID_HANDLE_VALUE;
+                HANDLE mapping = nullptr;
+#endif
+            };
+        }
+
+        /// Writes a CSR graph (e.g. CSRGraph::view()) to path in the navgraph format. Node payloads are written as raw bytes, so they must be trivially copyable
+        template <typename NodeT, typename IndexType, typename EdgeCostType>
+        NavGraphFileStatus writeNavGraph(const char* path, const CSRGraphView<NodeT, IndexType, EdgeCostType>& graph)
+        {
+            static_assert(std::is_trivially_copyable_v<NodeT>, "navgraph node payloads are stored as raw bytes");
+
+            const std::uint64_t nodeCount = graph.size();
+            const std::uint64_t edgeCount = graph.edge_count();
+            const std::uint64_t align = NavGraphFileHeader::sectionAlignment;
+
+            NavGraphFileHeader header = {};
+            std::memcpy(header.magic, NavGraphFileHeader::magicValue, sizeof(header.magic));
+            header.version = NavGraphFileHeader::currentVersion;
+            header.byteOrder = NavGraphFileHeader::byteOrderMark;
+            header.nodeSize = sizeof(NodeT);
+            header.indexSize = sizeof(IndexType);
+            header.edgeCostSize = sizeof(EdgeCostType);
+            header.nodeCount = nodeCount;
+            header.edgeCount = edgeCount;
+
+            // sections, in file order
+            struct Section
+            {
+                const void* data;
+                std::uint64_t bytes;
+                std::uint64_t* offset;
+            };
+
+            // an empty view has no offsets array; write the single 0 offset it implies
+            const IndexType zeroOffset = 0;
+
+            Section sections[4] =
+            {
+                { graph.node_data(), nodeCount * sizeof(NodeT), &header.nodesOffset },
+                { nodeCount ? static_cast<const void*>(graph.offset_data()) : &zeroOffset, (nodeCount + 1) * sizeof(IndexType), &header.offsetsOffset },
+                { graph.neighbor_data(), edgeCount * sizeof(IndexType), &header.neighborsOffset },
+                { graph.edge_cost_data(), graph.has_edge_costs() ? edgeCount * sizeof(EdgeCostType) : 0, &header.edgeCostsOffset }
+            };
+
+            std::uint64_t end = sizeof(NavGraphFileHeader);
+
+            for (Section& s : sections)
+            {
+                if (s.offset == &header.edgeCostsOffset && !graph.has_edge_costs())
+                {
+                    break;
+                }
+
+                *s.offset = detail::alignUp(end, align);
+                end = *s.offset + s.bytes;
+            }
+
+            header.fileSize = end;
+
+            // checksum runs over the body as written, padding included
+            static const unsigned char padding[NavGraphFileHeader::sectionAlignment] = {};
+            std::uint64_t hash = detail::fnv1aOffsetBasis;
+            std::uint64_t position = sizeof(NavGraphFileHeader);
+
+            for (const Section& s : sections)
+            {
+                if (*s.offset == 0)
+                {
+                    continue;
+                }
+
+                hash = detail::fnv1a(padding, std::size_t(*s.offset - position), hash);
+                hash = s.bytes ? detail::fnv1a(s.data, std::size_t(s.bytes), hash) : hash;
+                position = *s.offset + s.bytes;
+            }
+
+            header.checksum = hash;
+
+            std::FILE* file = std::fopen(path, "wb");
+
+            if (!file)
+            {
+                return NavGraphFileStatus::OpenFailed;
+            }
+
+            bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+            position = sizeof(NavGraphFileHeader);
+
+            for (const Section& s : sections)
+            {
+                if (!ok || *s.offset == 0)
+                {
+                    continue;
+                }
+
+                const std::size_t pad = std::size_t(*s.offset - position);
+                ok = (pad == 0 || std::fwrite(padding, 1, pad, file) == pad) && (s.bytes == 0 || std::fwrite(s.data, 1, std::size_t(s.bytes), file) == s.bytes);
+                position = *s.offset + s.bytes;
+            }
+
+            ok = (std::fclose(file) == 0) && ok;
+            return ok ? NavGraphFileStatus::Ok : NavGraphFileStatus::WriteFailed;
+        }
+
+        template <typename NodeT, typename IndexType, typename EdgeCostType>
+        NavGraphFileStatus writeNavGraph(const char* path, const CSRGraph<NodeT, IndexType, EdgeCostType>& graph)
+        {
+            return writeNavGraph(path, graph.view());
+        }
+
+        /// Read only navgraph loaded by mapping the file; graph() views the mapped pages directly, with no parsing or copying,
+        /// and several processes opening the same file share the same physical pages.
+        /// Usage: MappedNavGraph<MyNode> nav; if (nav.open("level.nav") == NavGraphFileStatus::Ok) AStar(context, nav.graph(), ...);
+        /// The view returned by graph() is valid until the file is closed or the MappedNavGraph is destroyed
+        template <typename NodeT, typename IndexType = std::uint32_t, typename EdgeCostType = float>
+        class MappedNavGraph
+        {
+        public:
+            using View = CSRGraphView<NodeT, IndexType, EdgeCostType>;
+
+            static_assert(std::is_trivially_copyable_v<NodeT>, "navgraph node payloads are stored as raw bytes");
+
+            /// Maps the file and validates the header and section bounds.
+            /// verifyChecksum reads every page of the file once to check it. verifyStructure checks that the row offsets are ascending and
+            /// every neighbor index names a node, which is what keeps searches on a damaged or hostile file inside the mapping.
+            /// Pass false for both for the fastest start when the file is trusted, in which case pages are only faulted in as the searches touch them
+            NavGraphFileStatus open(const char* path, bool verifyChecksum = true, bool verifyStructure = true)
+            {
+                close();
+
+                NavGraphFileStatus status = file.open(path);
+
+                if (status == NavGraphFileStatus::Ok)
+                {
+                    status = validate(verifyChecksum, verifyStructure);
+                }
+
+                if (status != NavGraphFileStatus::Ok)
+                {
+                    close();
+                    return status;
+                }
+
+                const unsigned char* base = file.bytes();
+                const NavGraphFileHeader& header = *reinterpret_cast<const NavGraphFileHeader*>(base);
+
+                view = View(reinterpret_cast<const NodeT*>(base + header.nodesOffset),
+                            std::size_t(header.nodeCount),
+                            reinterpret_cast<const IndexType*>(base + header.offsetsOffset),
+                            reinterpret_cast<const IndexType*>(base + header.neighborsOffset),
+                            header.edgeCostsOffset ? reinterpret_cast<const EdgeCostType*>(base + header.edgeCostsOffset) : nullptr);
+
+                return NavGraphFileStatus::Ok;
+            }
+
+            void close()
+            {
+                file.close();
+                view = View();
+            }
+
+            bool is_open() const
+            {
+                return file.bytes() != nullptr;
+            }
+
+            const View& graph() const
+            {
+                return view;
+            }
+
+        private:
+
+            NavGraphFileStatus validate(bool verifyChecksum, bool verifyStructure) const
+            {
+                const std::size_t size = file.byteSize();
+
+                if (size < sizeof(NavGraphFileHeader))
+                {
+                    return NavGraphFileStatus::Truncated;
+                }
+
+                const unsigned char* base = file.bytes();
+                const NavGraphFileHeader& header = *reinterpret_cast<const NavGraphFileHeader*>(base);
+
+                if (std::memcmp(header.magic, NavGraphFileHeader::magicValue, sizeof(header.magic)) != 0)
+                {
+                    return NavGraphFileStatus::BadMagic;
+                }
+
+                if (header.version != NavGraphFileHeader::currentVersion)
+                {
+                    return NavGraphFileStatus::VersionMismatch;
+                }
+
+                if (header.byteOrder != NavGraphFileHeader::byteOrderMark || header.nodeSize != sizeof(NodeT) ||
+                    header.indexSize != sizeof(IndexType) || header.edgeCostSize != sizeof(EdgeCostType))
+                {
+                    return NavGraphFileStatus::LayoutMismatch;
+                }
+
+                // neighbors are IndexTypes below nodeCount and offsets are IndexTypes up to edgeCount; keeping nodeCount below the maximum
+                // also keeps nodeCount + 1 from overflowing
+                constexpr std::uint64_t maxIndex = std::numeric_limits<IndexType>::max();
+
+                if (header.nodeCount >= maxIndex || header.edgeCount > maxIndex || header.nodeCount > std::numeric_limits<std::size_t>::max())
+                {
+                    return NavGraphFileStatus::Corrupt;
+                }
+
+                if (header.fileSize > size || header.fileSize < sizeof(NavGraphFileHeader) ||
+                    !sectionFits(header, header.nodesOffset, header.nodeCount, sizeof(NodeT)) ||
+                    !sectionFits(header, header.offsetsOffset, header.nodeCount + 1, sizeof(IndexType)) ||
+                    !sectionFits(header, header.neighborsOffset, header.edgeCount, sizeof(IndexType)) ||
+                    (header.edgeCostsOffset && !sectionFits(header, header.edgeCostsOffset, header.edgeCount, sizeof(EdgeCostType))))
+                {
+                    return NavGraphFileStatus::Truncated;
+                }
+
+                // sections are aligned to sectionAlignment within a page aligned mapping, so they can be read in place
+                const IndexType* offsets = reinterpret_cast<const IndexType*>(base + header.offsetsOffset);
+                const IndexType* neighbors = reinterpret_cast<const IndexType*>(base + header.neighborsOffset);
+
+                if (offsets[0] != 0 || std::uint64_t(offsets[header.nodeCount]) != header.edgeCount)
+                {
+                    return NavGraphFileStatus::Corrupt;
+                }
+
+                if (verifyStructure)
+                {
+                    // ascending offsets from 0 to edgeCount keep every row inside the neighbor section, and every neighbor must name a node
+                    for (std::uint64_t i = 0; i < header.nodeCount; ++i)
+                    {
+                        if (offsets[i + 1] < offsets[i])
+                        {
+                            return NavGraphFileStatus::Corrupt;
+                        }
+                    }
+
+                    for (std::uint64_t e = 0; e < header.edgeCount; ++e)
+                    {
+                        if (std::uint64_t(neighbors[e]) >= header.nodeCount)
+                        {
+                            return NavGraphFileStatus::Corrupt;
+                        }
+                    }
+                }
+
+                if (verifyChecksum && detail::fnv1a(base + sizeof(NavGraphFileHeader), std::size_t(header.fileSize - sizeof(NavGraphFileHeader))) != header.checksum)
+                {
+                    return NavGraphFileStatus::ChecksumMismatch;
+                }
+
+                return NavGraphFileStatus::Ok;
+            }
+
+            /// count elements of elementSize bytes at offset lie within the file; phrased as a division so huge counts can't overflow
+            static bool sectionFits(const NavGraphFileHeader& header, std::uint64_t offset, std::uint64_t count, std::uint64_t elementSize)
+            {
+                return offset >= sizeof(NavGraphFileHeader) && offset % NavGraphFileHeader::sectionAlignment == 0 &&
+                       offset <= header.fileSize && count <= (header.fileSize - offset) / elementSize;
+            }
+
+            detail::MappedFile file;
+            View view;
+        };
+    }
+}
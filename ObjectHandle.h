@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// Versioned handle shared by the object managers: a slot index and the version of the slot when the handle was issued, packed into one integer
+        /// IndexBits caps the number of slots, VersionBits how many times a slot can be reused before it has to be retired (see ObjectManager).
+        /// Versions start at 1, so the all zero value never refers to a live object
+        template <unsigned IndexBits = 24, unsigned VersionBits = 8, typename ValueT = std::uint32_t>
+        struct BasicObjectHandle
+        {
+            using ValueType = ValueT;
+
+            /// smallest unsigned type that holds a version, for the managers' per slot records
+            using VersionType = std::conditional_t<(VersionBits <= 8), std::uint8_t,
+                                std::conditional_t<(VersionBits <= 16), std::uint16_t,
+                                std::conditional_t<(VersionBits <= 32), std::uint32_t, std::uint64_t>>>;
+
+            static_assert(std::is_unsigned_v<ValueType>, "handle value type must be an unsigned integer");
+            static_assert(IndexBits > 0 && VersionBits > 0 && IndexBits + VersionBits <= sizeof(ValueType) * 8, "index and version must fit the handle value");
+
+            static constexpr unsigned indexBits = IndexBits;
+            static constexpr unsigned versionBits = VersionBits;
+            static constexpr ValueType maxIndex = ValueType(~ValueType(0) >> (sizeof(ValueType) * 8 - IndexBits));
+            static constexpr ValueType maxVersion = ValueType(~ValueType(0) >> (sizeof(ValueType) * 8 - VersionBits));
+
+            union
+            {
+                struct
+                {
+                    ValueType index : IndexBits;
+                    ValueType version : VersionBits;
+                };
+                ValueType value;
+            };
+
+            operator ValueType() const
+            {
+                return value;
+            }
+
+            BasicObjectHandle(ValueType v)
+            {
+                value = v;
+            }
+
+            BasicObjectHandle(ValueType idx, ValueType ver)
+            {
+                value = 0; // clear the bits above index and version so equal handles compare equal
+                index = idx;
+                version = ver;
+            }
+        };
+
+        /// Handle usage counters kept by the object managers when handle stats tracking is enabled
+        struct ObjectHandleStats
+        {
+            std::size_t staleLookups = 0; ///< lookups with an in range index but an outdated version (the object was removed, maybe replaced)
+            std::size_t staleRemoves = 0; ///< same, for removes
+            std::size_t peakSlots = 0;    ///< highest number of slots ever in use; needs to stay below 2^IndexBits
+            std::size_t maxVersion = 0;   ///< highest version issued; slots retire when it reaches 2^VersionBits - 1
+        };
+
+        /// the original layout: 24 bit index (16M slots), 8 bit version
+        using ObjectHandle = BasicObjectHandle<>;
+
+        /// 32 bit index, 32 bit version, for long running processes where slots get reused far more than 256 times
+        using ObjectHandle64 = BasicObjectHandle<32, 32, std::uint64_t>;
+    }
+}
@@ -1,20 +1,39 @@
 #pragma once
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <deque>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "ObjectHandle.h"
 
 namespace Virtuoso
 {
     namespace GameFoundations
     {
+        /// HandleType picks the handle layout (see BasicObjectHandle); a slot whose version would wrap is retired instead of reused,
+        /// so a stale handle can never resolve to a newer object. With TrackHandleStats, handleStats() counts stale handle hits and
+        /// the index / version ranges actually used, to size the handle layout for a workload
         template <typename ObjectType,
-            template <typename, typename = std::allocator<ObjectType>> class ObjectContainer = std::deque
+            template <typename, typename = std::allocator<ObjectType>> class ObjectContainer = std::deque,
+            typename HandleType = ObjectHandle,
+            bool TrackHandleStats = false
         >
         class ObjectManager
         {
+            using VersionType = typename HandleType::VersionType;
+            using IndexType = typename HandleType::ValueType;
+
             struct VersionRecord
             {
-                std::uint8_t version=0;
+                VersionType version=0;
                 bool valid = false;
 
-                bool operator==(const std::uint8_t& v)
+                bool operator==(const VersionType& v)
                 {
                     return valid && (v == version);
                 }
@@ -22,65 +41,99 @@ namespace Virtuoso
 
             ObjectContainer<ObjectType> objects;
             std::vector<VersionRecord> versions;
-            std::stack<uint32_t> freeIndices;
+            std::vector<IndexType> freeIndices; ///< used as a stack: the slot freed last is reused first
+            std::size_t retiredCount = 0;
+            ObjectHandleStats stats;
+            std::vector<std::uint64_t> liveMasks; ///< bit i % 64 of word i / 64 is set while slot i holds a live object
 
-        public:
+            void setLive(std::size_t index)
+            {
+                if (index / 64 >= liveMasks.size())
+                {
+                    liveMasks.resize(index / 64 + 1, 0u);
+                }
 
-            std::size_t size() { return objects.size() - freeIndices.size(); }
+                liveMasks[index / 64] |= std::uint64_t(1) << (index % 64);
+            }
 
-            void clear()
+            void clearLive(std::size_t index)
             {
-                objects.clear();
-                versions.clear();
-                freeIndices = std::stack<uint32_t>();
+                liveMasks[index / 64] &= ~(std::uint64_t(1) << (index % 64));
             }
 
-            struct Handle
+            /// puts object in a new slot at the end; a slot released by compact() still has its version record and continues from it
+            HandleType appendObject(ObjectType&& object)
             {
-                union
-                {
-                    struct
-                    {
-                        int32_t index : 24;
-                        uint32_t version : 8;
-                    };
-                    uint32_t value;
-                };
+                assert(objects.size() <= Handle::maxIndex && "handle index bits exhausted");
+                const std::size_t index = objects.size();
+                objects.push_back(std::move(object));
 
-                operator uint32_t() const
+                if (index == versions.size())
                 {
-                    return value;
+                    versions.push_back({ 0,false });
                 }
 
-                Handle(uint32_t v)
-                {
-                    value = v;
-                }
+                // a fresh record starts with version "1", otherwise the handle for version 0, index 0 just looks like null
+                VersionRecord& record = versions[index];
+                record.version++;
+                record.valid = true;
+                setLive(index);
 
-                Handle(int32_t idx, uint32_t ver) : index(idx), version(ver)
+                if constexpr (TrackHandleStats)
                 {
+                    stats.peakSlots = std::max(stats.peakSlots, objects.size());
+                    stats.maxVersion = std::max<std::size_t>(stats.maxVersion, record.version);
                 }
-            };
+
+                return { IndexType(index), record.version };
+            }
+
+        public:
+
+            std::size_t size() { return objects.size() - freeIndices.size() - retiredCount; }
+
+            void clear()
+            {
+                objects.clear();
+                versions.clear();
+                liveMasks.clear();
+                freeIndices.clear();
+                retiredCount = 0;
+                stats = ObjectHandleStats();
+            }
+
+            using Handle = HandleType;
 
             Handle insertObject(ObjectType&& object)
             {
                 if (freeIndices.empty())
                 {
-                    objects.push_back(std::move(object));
-                    versions.push_back({ 1,true }); // start with version "1", otherwise the handle for version 0, index 0 just looks like null
-                    return { (int32_t)(objects.size() - 1), 1u };
+                    return appendObject(std::move(object));
                 }
                 else
                 {
-                    uint32_t index = freeIndices.top();
-                    freeIndices.pop();
+                    IndexType index = freeIndices.back();
+                    freeIndices.pop_back();
                     objects[index] = std::move(object);
                     versions[index].version++;
                     versions[index].valid = true;
-                    return { (int32_t)(index), versions[index].version };
+                    setLive(index);
+
+                    if constexpr (TrackHandleStats)
+                    {
+                        stats.maxVersion = std::max<std::size_t>(stats.maxVersion, versions[index].version);
+                    }
+
+                    return { index, versions[index].version };
                 }
             }
 
+            /// slots taken out of service because their version reached Handle::maxVersion
+            std::size_t retiredSlots() const { return retiredCount; }
+
+            /// only counted when TrackHandleStats is set
+            const ObjectHandleStats& handleStats() const { return stats; }
+
             ObjectType* lookupObject(const Handle& handle)
             {
                 if (handle.index < objects.size() && versions[handle.index] == handle.version)
@@ -88,6 +141,7 @@ namespace Virtuoso
                     return &objects[handle.index];
                 }
 
+                countStale(handle, stats.staleLookups);
                 return nullptr; // Handle is invalid or object was deleted
             }
 
@@ -96,18 +150,221 @@ namespace Virtuoso
                 if (handle.index < objects.size() && versions[handle.index] == handle.version)
                 {
                     versions[handle.index].valid = false;
+                    clearLive(handle.index);
+
+                    if (versions[handle.index].version == Handle::maxVersion)
+                    {
+                        // another reuse would wrap the version and let old handles alias the new object; leave the slot empty for good
+                        ++retiredCount;
+                    }
+                    else
+                    {
+                        freeIndices.push_back(handle.index);
+                    }
 
-                    freeIndices.push(handle.index);
                     return true;
                 }
 
+                countStale(handle, stats.staleRemoves);
                 return false;
             }
 
+            /// Moves the objects of range into the manager and writes their handles to handles, in range order; returns how many were inserted
+            /// (stops when either runs out). Free slots are reused first, then the rest are appended in one go
+            template <std::ranges::input_range Range>
+            std::size_t insertObjects(Range&& range, std::span<Handle> handles)
+            {
+                auto it = std::ranges::begin(range);
+                const auto last = std::ranges::end(range);
+                std::size_t count = 0;
+
+                for (; it != last && count < handles.size() && !freeIndices.empty(); ++it, ++count)
+                {
+                    const IndexType index = freeIndices.back();
+                    freeIndices.pop_back();
+                    objects[index] = std::move(*it);
+                    VersionRecord& record = versions[index];
+                    record.version++;
+                    record.valid = true;
+                    setLive(index);
+                    handles[count] = { index, record.version };
+
+                    if constexpr (TrackHandleStats)
+                    {
+                        stats.maxVersion = std::max<std::size_t>(stats.maxVersion, record.version);
+                    }
+                }
+
+                if constexpr (std::ranges::sized_range<Range>)
+                {
+                    versions.reserve(versions.size() + std::min<std::size_t>(std::ranges::size(range) - count, handles.size() - count));
+                }
+
+                for (; it != last && count < handles.size(); ++it, ++count)
+                {
+                    handles[count] = appendObject(std::move(*it));
+                }
+
+                return count;
+            }
+
+            /// removeObject for every handle (a handle repeated in the batch is removed once); returns how many were live
+            /// One pass invalidates the version records and live bits and pushes the freed slots straight onto the free stack,
+            /// which is grown once for the whole batch; the count comes from how far the stack and the retired count grew
+            std::size_t removeObjects(std::span<const Handle> handles)
+            {
+                const std::size_t slotCount = objects.size();
+                const std::size_t retiredBefore = retiredCount;
+                const std::size_t freeBefore = freeIndices.size();
+
+                // grown geometrically, so a run of small batches doesn't reallocate on every call
+                if (freeBefore + handles.size() > freeIndices.capacity())
+                {
+                    freeIndices.reserve(std::max(freeBefore + handles.size(), 2 * freeIndices.capacity()));
+                }
+
+                for (const Handle& handle : handles)
+                {
+                    if (handle.index >= slotCount || !(versions[handle.index] == handle.version))
+                    {
+                        countStale(handle, stats.staleRemoves);
+                        continue;
+                    }
+
+                    VersionRecord& record = versions[handle.index];
+                    record.valid = false;
+                    clearLive(handle.index);
+
+                    if (record.version == Handle::maxVersion)
+                    {
+                        ++retiredCount;
+                    }
+                    else
+                    {
+                        freeIndices.push_back(handle.index);
+                    }
+                }
+
+                return (freeIndices.size() - freeBefore) + (retiredCount - retiredBefore);
+            }
+
+            /// out[i] = lookupObject(handles[i]); out must be at least as long as handles
+            void lookupObjects(std::span<const Handle> handles, std::span<ObjectType*> out)
+            {
+                assert(out.size() >= handles.size());
+
+                for (std::size_t i = 0; i < handles.size(); ++i)
+                {
+                    out[i] = lookupObject(handles[i]);
+                }
+            }
+
+            /// Defragments storage: live objects from the end move into free slots near the front, then trailing empty slots are released.
+            /// Returns the remap table: for every handle h that was live before the call, remap[h.index] is its handle now
+            /// (the same handle if the object didn't move). Entries for slots that held no live object are null handles.
+            /// Moved objects get a new version in their new slot, so the old handles of moved objects stop resolving;
+            /// handles that weren't live before the call keep failing to resolve, since released slots keep their version records
+            std::vector<Handle> compact()
+            {
+                const std::size_t slotCount = objects.size();
+                std::vector<Handle> remap;
+                remap.reserve(slotCount);
+
+                for (std::size_t i = 0; i < slotCount; ++i)
+                {
+                    remap.push_back(versions[i].valid ? Handle(IndexType(i), versions[i].version) : Handle(0u));
+                }
+
+                // holes that can take an object, lowest first (retired slots can't: their version is used up)
+                std::vector<IndexType> holes = std::move(freeIndices);
+                freeIndices.clear();
+                std::sort(holes.begin(), holes.end());
+
+                std::size_t nextHole = 0;
+                std::size_t source = slotCount;
+
+                while (nextHole < holes.size())
+                {
+                    // next live object from the back
+                    while (source > 0 && !versions[source - 1].valid)
+                    {
+                        --source;
+                    }
+
+                    if (source == 0 || source - 1 <= holes[nextHole])
+                    {
+                        break;
+                    }
+
+                    --source;
+                    const IndexType target = holes[nextHole++];
+
+                    objects[target] = std::move(objects[source]);
+                    versions[source].valid = false;
+                    clearLive(source);
+                    VersionRecord& record = versions[target];
+                    record.version++;
+                    record.valid = true;
+                    setLive(target);
+                    remap[source] = { target, record.version };
+
+                    // the vacated slot can still be reused later if it isn't released below
+                    if (versions[source].version != Handle::maxVersion)
+                    {
+                        holes.push_back(IndexType(source));
+                    }
+
+                    if constexpr (TrackHandleStats)
+                    {
+                        stats.maxVersion = std::max<std::size_t>(stats.maxVersion, record.version);
+                    }
+                }
+
+                // release the empty tail down to the last live or retired slot. Only the objects go: the version records stay,
+                // so a released slot that gets appended again continues from its old version instead of restarting at 1
+                while (!objects.empty() && !versions[objects.size() - 1].valid && versions[objects.size() - 1].version != Handle::maxVersion)
+                {
+                    objects.pop_back();
+                }
+
+                // pushed highest first, so the lowest free slots are reused first
+                for (std::size_t i = holes.size(); i > nextHole; --i)
+                {
+                    if (holes[i - 1] < objects.size())
+                    {
+                        freeIndices.push_back(holes[i - 1]);
+                    }
+                }
+
+                retiredCount = 0;
+
+                for (const VersionRecord& record : versions)
+                {
+                    retiredCount += (!record.valid && record.version == Handle::maxVersion) ? 1 : 0;
+                }
+
+                return remap;
+            }
+
+        private:
+
+            void countStale(const Handle& handle, std::size_t& counter)
+            {
+                if constexpr (TrackHandleStats)
+                {
+                    if (handle.index < objects.size() && handle.version != 0)
+                    {
+                        ++counter;
+                    }
+                }
+            }
+
+        public:
+
             class Iterator
             {
             private:
-                ObjectManager<ObjectType, ObjectContainer>* manager;
+                ObjectManager* manager;
                 size_t current;
 
                 void skipInvalid()
@@ -119,7 +376,7 @@ namespace Virtuoso
                 }
 
             public:
-                Iterator(ObjectManager<ObjectType, ObjectContainer>* manager, size_t start) : manager(manager), current(start)
+                Iterator(ObjectManager* manager, size_t start) : manager(manager), current(start)
                 {
                     skipInvalid();
                 }
@@ -155,6 +412,99 @@ namespace Virtuoso
             {
                 return Iterator(this, objects.size());
             }
+
+            /// A run of consecutive 64 slot blocks with the live objects in it counted up front.
+            /// Chunks never share a block, so each one can go to a different thread (std::for_each(std::execution::par, ...), a job system, ...)
+            class LiveChunk
+            {
+            public:
+                LiveChunk(ObjectManager* manager, std::size_t firstBlock, std::size_t blockCount, std::size_t liveObjects)
+                    : manager(manager), firstBlock(firstBlock), blockCount(blockCount), liveObjects(liveObjects)
+                {
+                }
+
+                std::size_t firstSlot() const { return firstBlock * 64; }
+                std::size_t slotCount() const { return std::min(blockCount * 64, manager->objects.size() - firstSlot()); }
+                std::size_t liveCount() const { return liveObjects; }
+
+                /// calls f(object) or f(object, handle) for each live object of the chunk, in slot order, visiting only the set bits of the live masks
+                template <typename Fn>
+                void forEach(Fn&& f) const
+                {
+                    for (std::size_t block = firstBlock; block < firstBlock + blockCount; ++block)
+                    {
+                        std::uint64_t mask = manager->liveMasks[block];
+
+                        while (mask)
+                        {
+                            const std::size_t index = block * 64 + std::size_t(std::countr_zero(mask));
+                            mask &= mask - 1;
+
+                            if constexpr (std::is_invocable_v<Fn&, ObjectType&, Handle>)
+                            {
+                                f(manager->objects[index], Handle(IndexType(index), manager->versions[index].version));
+                            }
+                            else
+                            {
+                                f(manager->objects[index]);
+                            }
+                        }
+                    }
+                }
+
+            private:
+                ObjectManager* manager;
+                std::size_t firstBlock;
+                std::size_t blockCount;
+                std::size_t liveObjects;
+            };
+
+            /// Splits the slot space into chunks of whole 64 slot blocks, each holding about targetLiveObjects live objects,
+            /// so chunks stand for roughly the same amount of work however the holes are spread. Blocks with no live object are skipped.
+            /// The chunks are valid until the next insert or remove; objects themselves can be modified from the chunks in parallel.
+            /// Fills chunks (cleared first) so the vector can be reused from frame to frame
+            void liveChunks(std::vector<LiveChunk>& chunks, std::size_t targetLiveObjects = 256)
+            {
+                chunks.clear();
+
+                std::size_t first = 0;
+                std::size_t live = 0;
+
+                for (std::size_t block = 0; block < liveMasks.size(); ++block)
+                {
+                    const std::size_t blockLive = std::size_t(std::popcount(liveMasks[block]));
+
+                    if (live == 0)
+                    {
+                        if (blockLive == 0)
+                        {
+                            continue;
+                        }
+
+                        first = block;
+                    }
+
+                    live += blockLive;
+
+                    if (live >= targetLiveObjects)
+                    {
+                        chunks.emplace_back(this, first, block + 1 - first, live);
+                        live = 0;
+                    }
+                }
+
+                if (live > 0)
+                {
+                    chunks.emplace_back(this, first, liveMasks.size() - first, live);
+                }
+            }
+
+            std::vector<LiveChunk> liveChunks(std::size_t targetLiveObjects = 256)
+            {
+                std::vector<LiveChunk> chunks;
+                liveChunks(chunks, targetLiveObjects);
+                return chunks;
+            }
         };
     }
 }
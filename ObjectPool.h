@@ -1,4 +1,9 @@
 #pragma once
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
 
 namespace Virtuoso
 {
@@ -1,10 +1,85 @@
 #pragma once
-#include <deque>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace Virtuoso
 {
     namespace GameFoundations
     {
+        /// How many objects ObjectPoolDynamic adds each time it runs out
+        struct PoolGrowthPolicy
+        {
+            enum class Kind
+            {
+                Fixed,      ///< always fixedSize objects
+                Geometric,  ///< factor times the current size (clamped to [minimum, maximum]), so bursts need few expansions
+                Callback    ///< whatever callback(currentSize) returns
+            };
+
+            Kind kind = Kind::Fixed;
+            std::size_t fixedSize = 1;
+            double factor = 1.0;
+            std::size_t minimum = 1;
+            std::size_t maximum = std::numeric_limits<std::size_t>::max();
+            std::function<std::size_t(std::size_t)> callback;
+
+            static PoolGrowthPolicy fixed(std::size_t size)
+            {
+                PoolGrowthPolicy policy;
+                policy.fixedSize = size;
+                return policy;
+            }
+
+            static PoolGrowthPolicy geometric(double factor = 1.0, std::size_t minimum = 16, std::size_t maximum = std::numeric_limits<std::size_t>::max())
+            {
+                PoolGrowthPolicy policy;
+                policy.kind = Kind::Geometric;
+                policy.factor = factor;
+                policy.minimum = minimum;
+                policy.maximum = maximum;
+                return policy;
+            }
+
+            static PoolGrowthPolicy fromCallback(std::function<std::size_t(std::size_t)> callback)
+            {
+                PoolGrowthPolicy policy;
+                policy.kind = Kind::Callback;
+                policy.callback = std::move(callback);
+                return policy;
+            }
+
+            /// size of the next expansion for a pool currently holding currentSize objects; always at least 1
+            std::size_t expansionSize(std::size_t currentSize) const
+            {
+                std::size_t n = fixedSize;
+
+                if (kind == Kind::Geometric)
+                {
+                    n = std::clamp(std::size_t(double(currentSize) * factor), minimum, maximum);
+                }
+                else if (kind == Kind::Callback)
+                {
+                    n = callback(currentSize);
+                }
+
+                return std::max<std::size_t>(n, 1);
+            }
+        };
+
+        /// Counters for tuning reserve sizes and growth policies per object type
+        struct PoolStats
+        {
+            std::size_t highWaterMark = 0;   ///< most objects out of the pool at the same time
+            std::size_t expansions = 0;      ///< chunks added (reserve included)
+            std::size_t objectsCreated = 0;  ///< Initializer calls
+            std::size_t chunksReleased = 0;  ///< chunks given back by trim()
+        };
 
         /// Object Pool (Dynamic)
         /// Has the following properties
@@ -13,6 +88,8 @@ namespace Virtuoso
         /// Since this is the dynamic version of the pool, you can tell it an expansion size when it runs out of objects or give it a reserve size
         /// This is useful for eg. particles or rockets or other things where you want to pay the initialization cost once (eg for PhysicsActors)
         /// and repurpose them as objects are created or destroyed
+        /// Storage is a list of contiguous chunks, one per expansion, each initialized in one go. ExpansionSize sets the default fixed
+        /// growth; setGrowthPolicy() switches to geometric or callback driven growth. trim() gives fully free chunks back
         template<typename T, typename Initializer, std::size_t ExpansionSize = 1>
         class ObjectPoolDynamic
         {
@@ -35,51 +112,169 @@ namespace Virtuoso
 
             bool acquire(T& outObj)
             {
-                if (m_nextAvailable >= size())
+                if (m_nextAvailable >= m_capacity)
                 {
                     expandPool();
-                    assert(m_nextAvailable < size());
+                    assert(m_nextAvailable < m_capacity);
                 }
 
-                outObj = std::move(m_pool[m_nextAvailable++]);
+                outObj = std::move(takeNext());
                 return true;
             }
 
             void release(T&& obj)
             {
                 assert(m_nextAvailable > 0);
-                m_pool[--m_nextAvailable] = std::move(obj);
+                putBack() = std::move(obj);
+            }
+
+            /// moves count objects out of the pool onto the back of out (anything with push_back), expanding the pool as needed
+            template <typename Container>
+            void acquireBatch(Container& out, std::size_t count)
+            {
+                if (m_nextAvailable + count > m_capacity)
+                {
+                    addChunk(std::max(m_growth.expansionSize(m_capacity), m_nextAvailable + count - m_capacity));
+                }
+
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    out.push_back(std::move(takeNext()));
+                }
+            }
+
+            /// returns every object of [first, last) to the pool
+            template <typename Iterator>
+            void releaseBatch(Iterator first, Iterator last)
+            {
+                for (; first != last; ++first)
+                {
+                    assert(m_nextAvailable > 0);
+                    putBack() = std::move(*first);
+                }
             }
 
+            /// grows the pool to at least reserveSize objects with a single chunk
             inline void reserve(int reserveSize)
             {
-                while (m_pool.size() < reserveSize)
+                if (std::size_t(reserveSize) > m_capacity)
                 {
-                    expandPool();
+                    addChunk(std::size_t(reserveSize) - m_capacity);
+                }
+            }
+
+            /// Releases chunks with no object out of the pool, newest first, as long as at least keepAvailable objects stay available.
+            /// Returns the number of objects released
+            std::size_t trim(std::size_t keepAvailable = 0)
+            {
+                std::size_t released = 0;
+
+                while (!m_chunks.empty() && lastChunkFree())
+                {
+                    const std::size_t chunkSize = m_chunks.back().size();
+
+                    if (m_capacity - chunkSize < m_nextAvailable + keepAvailable)
+                    {
+                        break;
+                    }
+
+                    m_chunks.pop_back();
+                    m_capacity -= chunkSize;
+                    released += chunkSize;
+                    ++m_stats.chunksReleased;
                 }
+
+                return released;
+            }
+
+            void setGrowthPolicy(PoolGrowthPolicy policy)
+            {
+                m_growth = std::move(policy);
+            }
+
+            const PoolStats& stats() const
+            {
+                return m_stats;
             }
 
             inline int size() const
             {
-                return m_pool.size();
+                return int(m_capacity);
+            }
+
+            /// objects currently out of the pool
+            std::size_t inUse() const
+            {
+                return m_nextAvailable;
             }
 
-            //private:
-            std::deque<T> m_pool;
-            size_t m_nextAvailable=0;
             Initializer init;
 
         private:
 
+            /// chunks are used in order: objects before the cursor (chunk, offset) are out of the pool, the ones from it on are available
+            std::vector<std::vector<T>> m_chunks;
+            std::size_t m_cursorChunk = 0;
+            std::size_t m_cursorOffset = 0;
+            std::size_t m_nextAvailable = 0;
+            std::size_t m_capacity = 0;
+            PoolGrowthPolicy m_growth = PoolGrowthPolicy::fixed(ExpansionSize);
+            PoolStats m_stats;
+
+            T& takeNext()
+            {
+                T& object = m_chunks[m_cursorChunk][m_cursorOffset];
+
+                if (++m_cursorOffset == m_chunks[m_cursorChunk].size())
+                {
+                    ++m_cursorChunk;
+                    m_cursorOffset = 0;
+                }
+
+                m_stats.highWaterMark = std::max(m_stats.highWaterMark, ++m_nextAvailable);
+                return object;
+            }
+
+            T& putBack()
+            {
+                if (m_cursorOffset == 0)
+                {
+                    --m_cursorChunk;
+                    m_cursorOffset = m_chunks[m_cursorChunk].size();
+                }
+
+                --m_nextAvailable;
+                return m_chunks[m_cursorChunk][--m_cursorOffset];
+            }
+
+            bool lastChunkFree() const
+            {
+                const std::size_t last = m_chunks.size() - 1;
+                return last > m_cursorChunk || (last == m_cursorChunk && m_cursorOffset == 0);
+            }
+
             inline void expandPool()
             {
-                for (std::size_t i = 0; i < ExpansionSize; ++i)
+                addChunk(m_growth.expansionSize(m_capacity));
+            }
+
+            /// initializes a whole chunk at once, in contiguous storage allocated up front
+            void addChunk(std::size_t count)
+            {
+                std::vector<T> chunk;
+                chunk.reserve(count);
+
+                for (std::size_t i = 0; i < count; ++i)
                 {
-                    m_pool.push_back(std::move(init()));
+                    chunk.push_back(init());
                 }
+
+                m_chunks.push_back(std::move(chunk));
+                m_capacity += count;
+                ++m_stats.expansions;
+                m_stats.objectsCreated += count;
             }
         };
 
     }
 }
-
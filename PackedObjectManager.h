@@ -0,0 +1,170 @@
+#pragma once
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <stack>
+#include <utility>
+#include <vector>
+
+#include "ObjectHandle.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// ObjectManager variant that keeps live objects packed (sparse set)
+        /// Objects live contiguously in a dense array; handles index a sparse slot table that points into it.
+        /// removeObject moves the last object into the hole (swap-remove), so the dense array never has gaps and iteration
+        /// is a linear walk over exactly size() objects, however many slots have been freed.
+        /// Lookup costs one extra indirection compared to ObjectManager, and object addresses change when another object is removed:
+        /// keep handles, not pointers, across removals. The order of iteration is not the order of insertion.
+        /// Like ObjectManager, slots whose version would wrap are retired
+        template <typename ObjectType, typename HandleType = ObjectHandle>
+        class PackedObjectManager
+        {
+            using VersionType = typename HandleType::VersionType;
+            using IndexType = typename HandleType::ValueType;
+
+            struct SlotRecord
+            {
+                std::uint32_t denseIndex = 0;
+                VersionType version = 0;
+                bool valid = false;
+
+                bool operator==(const VersionType& v) const
+                {
+                    return valid && (v == version);
+                }
+            };
+
+            std::vector<ObjectType> objects;       ///< live objects, packed
+            std::vector<std::uint32_t> slotOfDense; ///< slot index of each packed object, to fix up the slot table on swap-remove
+            std::vector<SlotRecord> slots;
+            std::stack<IndexType> freeIndices;
+
+        public:
+
+            using Handle = HandleType;
+            using Iterator = typename std::vector<ObjectType>::iterator;
+            using ConstIterator = typename std::vector<ObjectType>::const_iterator;
+
+            std::size_t size() const { return objects.size(); }
+
+            void clear()
+            {
+                objects.clear();
+                slotOfDense.clear();
+                slots.clear();
+                freeIndices = std::stack<IndexType>();
+            }
+
+            void reserve(std::size_t n)
+            {
+                objects.reserve(n);
+                slotOfDense.reserve(n);
+                slots.reserve(n);
+            }
+
+            Handle insertObject(ObjectType&& object)
+            {
+                const std::uint32_t denseIndex = std::uint32_t(objects.size());
+                objects.push_back(std::move(object));
+
+                IndexType index;
+
+                if (freeIndices.empty())
+                {
+                    assert(slots.size() <= Handle::maxIndex && "handle index bits exhausted");
+                    index = IndexType(slots.size());
+                    slots.push_back({ denseIndex, 0, true });
+                }
+                else
+                {
+                    index = freeIndices.top();
+                    freeIndices.pop();
+                    slots[index].denseIndex = denseIndex;
+                    slots[index].valid = true;
+                }
+
+                // versions start at "1", otherwise the handle for version 0, index 0 just looks like null
+                slots[index].version++;
+                slotOfDense.push_back(index);
+                return { index, slots[index].version };
+            }
+
+            ObjectType* lookupObject(const Handle& handle)
+            {
+                if (isLive(handle))
+                {
+                    return &objects[slots[handle.index].denseIndex];
+                }
+
+                return nullptr; // Handle is invalid or object was deleted
+            }
+
+            const ObjectType* lookupObject(const Handle& handle) const
+            {
+                if (isLive(handle))
+                {
+                    return &objects[slots[handle.index].denseIndex];
+                }
+
+                return nullptr;
+            }
+
+            bool removeObject(const Handle& handle)
+            {
+                if (!isLive(handle))
+                {
+                    return false;
+                }
+
+                SlotRecord& slot = slots[handle.index];
+                const std::uint32_t hole = slot.denseIndex;
+                const std::uint32_t last = std::uint32_t(objects.size() - 1);
+
+                if (hole != last)
+                {
+                    objects[hole] = std::move(objects[last]);
+                    slotOfDense[hole] = slotOfDense[last];
+                    slots[slotOfDense[hole]].denseIndex = hole;
+                }
+
+                objects.pop_back();
+                slotOfDense.pop_back();
+
+                slot.valid = false;
+
+                if (slot.version != Handle::maxVersion)
+                {
+                    freeIndices.push(handle.index);
+                }
+
+                return true;
+            }
+
+            /// handle of the object at a position of the packed array, e.g. while iterating
+            Handle handleAt(std::size_t denseIndex) const
+            {
+                const std::uint32_t index = slotOfDense[denseIndex];
+                return { index, slots[index].version };
+            }
+
+            /// the live objects, in iteration order; invalidated by insert and remove
+            std::span<ObjectType> data() { return objects; }
+            std::span<const ObjectType> data() const { return objects; }
+
+            Iterator begin() { return objects.begin(); }
+            Iterator end() { return objects.end(); }
+            ConstIterator begin() const { return objects.begin(); }
+            ConstIterator end() const { return objects.end(); }
+
+        private:
+
+            bool isLive(const Handle& handle) const
+            {
+                return handle.index < slots.size() && slots[handle.index] == handle.version;
+            }
+        };
+    }
+}
@@ -1,38 +1,75 @@
 #pragma once
-
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+/// Fixed capacity ring keeping the last Capacity elements pushed; pushing onto a full ring overwrites the oldest element.
+/// Element 0 is the oldest. Power of two capacities wrap with a mask instead of a modulo.
+/// Slots are uninitialized storage: only the elements actually in the ring are constructed, so T needn't be default constructible
 template <typename T, std::size_t Capacity>
 class RingBuffer
 {
+    static_assert(Capacity > 0, "ring needs at least one slot");
+
+    static constexpr bool powerOfTwo = (Capacity & (Capacity - 1)) == 0;
+
     std::size_t count = 0;
     std::size_t cursor = 0;
-    using Base = std::array<T, Capacity>;
 
-    Base buffer;
-
-    std::size_t wraparound_negative(int x) const
+    // a union member array isn't constructed or destroyed implicitly; the ring constructs / destroys the live elements itself
+    union Storage
     {
-        assert(x < 0);
-        return  (((-x) + 1) * Capacity + x) % Capacity;
-    }
+        Storage() {}
+        ~Storage() {}
 
-    std::size_t wraparound(int x) const
+        T items[Capacity];
+    };
+
+    Storage buffer;
+
+    // x is always below 2 * Capacity (positions are offset by Capacity rather than going negative), so one conditional subtract is enough
+    static std::size_t wraparound(std::size_t x)
     {
-        return x < 0 ? wraparound_negative(x) : (x % Capacity);
+        if constexpr (powerOfTwo)
+        {
+            return x & (Capacity - 1);
+        }
+        else
+        {
+            return x >= Capacity ? x - Capacity : x;
+        }
     }
 
     std::size_t index_of_element(std::size_t i) const
     {
-        return wraparound(int(cursor) - int(count) + (int)(i));
+        return wraparound(cursor + Capacity - count + i);
     }
 
     std::size_t start_index() const
     {
-        return wraparound(int(cursor) - int(count));
+        return wraparound(cursor + Capacity - count);
     }
 
     std::size_t last_index() const
     {
-        return wraparound(cursor - 1);
+        return wraparound(cursor + Capacity - 1);
+    }
+
+    // calls f(slot, offset, length) for the (at most two) contiguous runs covering n slots from slot start on
+    template <typename F>
+    static void for_each_run(std::size_t start, std::size_t n, F&& f)
+    {
+        const std::size_t first = std::min(n, Capacity - start);
+        f(start, std::size_t(0), first);
+
+        if (n > first)
+        {
+            f(std::size_t(0), first, n - first);
+        }
     }
 
 public:
@@ -42,7 +79,7 @@ public:
         std::size_t index = 0;
         RingBuffer<T, Capacity>& parent;
 
-        iterator(RingBuffer<T, Capacity>& p, std::size_t idx = 0) : parent(p), index(idx) {}
+        iterator(RingBuffer<T, Capacity>& p, std::size_t idx = 0) : index(idx), parent(p) {}
 
         iterator operator++(int)
         {
@@ -76,12 +113,12 @@ public:
 
         T& operator*()
         {
-            return parent[parent.index_of_element(index)];
+            return parent[index];
         }
 
         const T& operator*() const
         {
-            return parent[parent.index_of_element(index)];
+            return parent[index];
         }
 
         bool operator==(const iterator& other) const
@@ -95,62 +132,188 @@ public:
         }
     };
 
+    RingBuffer() = default;
+
+    RingBuffer(const RingBuffer& other)
+    {
+        for (std::size_t i = 0; i < other.count; ++i)
+        {
+            emplace_back(other[i]);
+        }
+    }
+
+    RingBuffer(RingBuffer&& other)
+    {
+        for (std::size_t i = 0; i < other.count; ++i)
+        {
+            emplace_back(std::move(other[i]));
+        }
+
+        other.clear();
+    }
+
+    RingBuffer& operator=(const RingBuffer& other)
+    {
+        if (this != &other)
+        {
+            clear();
+
+            for (std::size_t i = 0; i < other.count; ++i)
+            {
+                emplace_back(other[i]);
+            }
+        }
+
+        return *this;
+    }
+
+    RingBuffer& operator=(RingBuffer&& other)
+    {
+        if (this != &other)
+        {
+            clear();
+
+            for (std::size_t i = 0; i < other.count; ++i)
+            {
+                emplace_back(std::move(other[i]));
+            }
+
+            other.clear();
+        }
+
+        return *this;
+    }
+
+    ~RingBuffer()
+    {
+        clear();
+    }
+
+    /// constructs an element in place at the back; on a full ring the new value is move assigned over the oldest element instead
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        T* slot = buffer.items + cursor;
+
+        if (full())
+        {
+            // build the value before touching the oldest element, args may refer to it. Assigning (like push_back_n does)
+            // keeps the slot holding a live object even if the move throws, where destroy + construct could leave it empty
+            T value(std::forward<Args>(args)...);
+            *slot = std::move(value);
+        }
+        else
+        {
+            std::construct_at(slot, std::forward<Args>(args)...);
+            count++;
+        }
+
+        cursor = wraparound(cursor + 1);
+        return *slot;
+    }
+
     void push_back(const T& val)
     {
-        buffer[cursor] = val;
-        if (count < Capacity) count++;
-        cursor = (cursor + 1) % Capacity;
+        emplace_back(val);
     }
 
     void push_back(T&& val)
     {
-        buffer[cursor] = std::move(val);
-        if (count < Capacity) count++;
-        cursor = (cursor + 1) % Capacity;
+        emplace_back(std::move(val));
+    }
+
+    /// appends vals as if push_back'ed one by one, with at most two block copies into free slots and two over the oldest elements
+    /// (memmoves for trivially copyable T). Only the last Capacity values can survive, so earlier ones are skipped. vals must not point into the ring
+    void push_back_n(std::span<const T> vals)
+    {
+        if (vals.size() > Capacity)
+        {
+            vals = vals.last(Capacity);
+        }
+
+        const std::size_t n = vals.size();
+        const std::size_t fresh = std::min(n, Capacity - count);
+
+        // the first free slots get constructed, after them the ring wraps onto its oldest elements, which get assigned over
+        for_each_run(cursor, fresh, [&](std::size_t slot, std::size_t offset, std::size_t length)
+        {
+            std::uninitialized_copy_n(vals.data() + offset, length, buffer.items + slot);
+        });
+
+        for_each_run(wraparound(cursor + fresh), n - fresh, [&](std::size_t slot, std::size_t offset, std::size_t length)
+        {
+            std::copy_n(vals.data() + fresh + offset, length, buffer.items + slot);
+        });
+
+        cursor = wraparound(cursor + n);
+        count = std::min(count + n, Capacity);
+    }
+
+    /// moves the oldest min(out.size(), size()) elements into out, in at most two block moves, and removes them; returns how many were popped
+    std::size_t pop_front_n(std::span<T> out)
+    {
+        const std::size_t n = std::min(out.size(), count);
+
+        for_each_run(start_index(), n, [&](std::size_t slot, std::size_t offset, std::size_t length)
+        {
+            std::move(buffer.items + slot, buffer.items + slot + length, out.data() + offset);
+            std::destroy_n(buffer.items + slot, length);
+        });
+
+        count -= n;
+        return n;
+    }
+
+    void pop_front()
+    {
+        assert(!empty());
+        std::destroy_at(buffer.items + start_index());
+        count--;
     }
 
     void pop_back()
     {
         assert(!empty());
-        cursor = wraparound(cursor - 1);
+        cursor = wraparound(cursor + Capacity - 1);
+        std::destroy_at(buffer.items + cursor);
         count--;
     }
 
     T& front()
     {
         assert(!empty());
-        return buffer[start_index()];
+        return buffer.items[start_index()];
     }
 
     T& back() {
         assert(!empty());
-        return buffer[last_index()];
+        return buffer.items[last_index()];
     }
 
     const T& front() const
     {
         assert(!empty());
-        return buffer[start_index()];
+        return buffer.items[start_index()];
     }
 
     const T& back() const
     {
         assert(!empty());
-        return buffer[last_index()];
+        return buffer.items[last_index()];
     }
 
     T& operator[](const std::size_t& i)
     {
         assert(i >= 0);
         assert(i < count);
-        return buffer[index_of_element(i)];
+        return buffer.items[index_of_element(i)];
     }
 
     const T& operator[](const std::size_t& i) const
     {
         assert(i >= 0);
         assert(i < count);
-        return buffer[index_of_element(i)];
+        return buffer.items[index_of_element(i)];
     }
 
     std::size_t size() const
@@ -170,6 +333,14 @@ public:
 
     void clear()
     {
+        if constexpr (!std::is_trivially_destructible_v<T>)
+        {
+            for_each_run(start_index(), count, [&](std::size_t slot, std::size_t, std::size_t length)
+            {
+                std::destroy_n(buffer.items + slot, length);
+            });
+        }
+
         count = 0;
         cursor = 0;
     }
@@ -179,6 +350,22 @@ public:
         return Capacity;
     }
 
+    /// the contents, oldest first, as at most two contiguous runs (second is empty unless the elements wrap past the end of the storage)
+    /// Valid until the next push / pop; use them for bulk copies or reductions without per element index math
+    std::pair<std::span<T>, std::span<T>> segments()
+    {
+        const std::size_t start = start_index();
+        const std::size_t firstSize = std::min(count, Capacity - start);
+        return { std::span<T>(buffer.items + start, firstSize), std::span<T>(buffer.items, count - firstSize) };
+    }
+
+    std::pair<std::span<const T>, std::span<const T>> segments() const
+    {
+        const std::size_t start = start_index();
+        const std::size_t firstSize = std::min(count, Capacity - start);
+        return { std::span<const T>(buffer.items + start, firstSize), std::span<const T>(buffer.items, count - firstSize) };
+    }
+
     iterator begin()
     {
         return iterator(*this, 0);
@@ -0,0 +1,475 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+// picks the SSE2 reductions below; local to this header, #undef'd at its end
+#define GAMEFOUNDATION_RINGBUFFER_SSE2 1
+#endif
+
+#include "RingBuffer.h"
+
+/// Sliding window over the last Capacity samples of an arithmetic T (frame times, latencies, RTTs) with O(1) statistics:
+/// sum, mean and variance are updated incrementally (Welford's update, run backwards for the sample that falls out of the window)
+/// and min / max come from monotonic queues whose fronts are always the current extremes.
+/// Each push costs amortized O(1); queries are O(1). samples() exposes the window itself, e.g. for RingBufferReduce::percentile
+template <typename T, std::size_t Capacity>
+class WindowedStatistics
+{
+    static_assert(std::is_arithmetic_v<T>, "WindowedStatistics needs an arithmetic sample type");
+
+    struct Entry
+    {
+        std::uint64_t sequence; ///< push number, to tell when an extreme has left the window
+        T value;
+    };
+
+    RingBuffer<T, Capacity> window;
+    RingBuffer<Entry, Capacity> minQueue; ///< increasing values, front is the minimum
+    RingBuffer<Entry, Capacity> maxQueue; ///< decreasing values, front is the maximum
+    std::uint64_t pushed = 0;
+    double runningMean = 0.0;
+    double m2 = 0.0;                      ///< sum of squared differences from the mean
+
+    void evict()
+    {
+        const double old = double(window.front());
+        const std::uint64_t oldest = pushed - window.size();
+
+        window.pop_front();
+
+        if (window.empty())
+        {
+            runningMean = 0.0;
+            m2 = 0.0;
+        }
+        else
+        {
+            const double delta = old - runningMean;
+            runningMean -= delta / double(window.size());
+            m2 = std::max(0.0, m2 - delta * (old - runningMean));
+        }
+
+        if (minQueue.front().sequence == oldest) minQueue.pop_front();
+        if (maxQueue.front().sequence == oldest) maxQueue.pop_front();
+    }
+
+public:
+
+    /// adds a sample, dropping the oldest one once the window is full
+    void push(T value)
+    {
+        if (window.full())
+        {
+            evict();
+        }
+
+        window.push_back(value);
+
+        const double delta = double(value) - runningMean;
+        runningMean += delta / double(window.size());
+        m2 += delta * (double(value) - runningMean);
+
+        while (!minQueue.empty() && !(minQueue.back().value < value)) minQueue.pop_back();
+        while (!maxQueue.empty() && !(value < maxQueue.back().value)) maxQueue.pop_back();
+
+        minQueue.push_back({ pushed, value });
+        maxQueue.push_back({ pushed, value });
+        ++pushed;
+    }
+
+    std::size_t size() const
+    {
+        return window.size();
+    }
+
+    bool empty() const
+    {
+        return window.empty();
+    }
+
+    double sum() const
+    {
+        return runningMean * double(window.size());
+    }
+
+    double mean() const
+    {
+        return runningMean;
+    }
+
+    /// population variance of the samples in the window
+    double variance() const
+    {
+        return window.empty() ? 0.0 : m2 / double(window.size());
+    }
+
+    double stddev() const
+    {
+        return std::sqrt(variance());
+    }
+
+    T min() const
+    {
+        assert(!empty());
+        return minQueue.front().value;
+    }
+
+    T max() const
+    {
+        assert(!empty());
+        return maxQueue.front().value;
+    }
+
+    const RingBuffer<T, Capacity>& samples() const
+    {
+        return window;
+    }
+
+    void clear()
+    {
+        window.clear();
+        minQueue.clear();
+        maxQueue.clear();
+        runningMean = 0.0;
+        m2 = 0.0;
+    }
+};
+
+/// On demand reductions over a whole RingBuffer of arithmetic T, run over its contiguous segments() rather than element by element.
+/// float and double use AVX or SSE2 when the build targets them; other types (and other targets) use a scalar loop.
+/// Sums accumulate in double for floating point T and in 64 bit integers otherwise. NaN handling of min / max is unspecified
+struct RingBufferReduce
+{
+    template <typename T>
+    using SumType = std::conditional_t<std::is_floating_point_v<T>, double, std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>>;
+
+    template <typename T, std::size_t Capacity>
+    static SumType<T> sum(const RingBuffer<T, Capacity>& ring)
+    {
+        static_assert(std::is_arithmetic_v<T>, "reductions need an arithmetic element type");
+        const auto [first, second] = ring.segments();
+        return sumOf(first.data(), first.size()) + sumOf(second.data(), second.size());
+    }
+
+    template <typename T, std::size_t Capacity>
+    static double mean(const RingBuffer<T, Capacity>& ring)
+    {
+        return ring.empty() ? 0.0 : double(sum(ring)) / double(ring.size());
+    }
+
+    template <typename T, std::size_t Capacity>
+    static T min(const RingBuffer<T, Capacity>& ring)
+    {
+        static_assert(std::is_arithmetic_v<T>, "reductions need an arithmetic element type");
+        assert(!ring.empty());
+        const auto [first, second] = ring.segments();
+        const T m = minOf(first.data(), first.size());
+        return second.empty() ? m : std::min(m, minOf(second.data(), second.size()));
+    }
+
+    template <typename T, std::size_t Capacity>
+    static T max(const RingBuffer<T, Capacity>& ring)
+    {
+        static_assert(std::is_arithmetic_v<T>, "reductions need an arithmetic element type");
+        assert(!ring.empty());
+        const auto [first, second] = ring.segments();
+        const T m = maxOf(first.data(), first.size());
+        return second.empty() ? m : std::max(m, maxOf(second.data(), second.size()));
+    }
+
+    /// value below which a fraction p (0..1) of the elements fall (nearest rank); scratch is reused to avoid allocating every call
+    template <typename T, std::size_t Capacity>
+    static T percentile(const RingBuffer<T, Capacity>& ring, double p, std::vector<T>& scratch)
+    {
+        assert(!ring.empty());
+        const auto [first, second] = ring.segments();
+
+        scratch.assign(first.begin(), first.end());
+        scratch.insert(scratch.end(), second.begin(), second.end());
+
+        const std::size_t rank = std::min(scratch.size() - 1, std::size_t(std::clamp(p, 0.0, 1.0) * double(scratch.size() - 1) + 0.5));
+        std::nth_element(scratch.begin(), scratch.begin() + rank, scratch.end());
+        return scratch[rank];
+    }
+
+private:
+
+    // scalar fallbacks
+
+    template <typename T>
+    static SumType<T> sumOf(const T* data, std::size_t n)
+    {
+        SumType<T> total = 0;
+
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            total += SumType<T>(data[i]);
+        }
+
+        return total;
+    }
+
+    template <typename T>
+    static T minOf(const T* data, std::size_t n)
+    {
+        return *std::min_element(data, data + n);
+    }
+
+    template <typename T>
+    static T maxOf(const T* data, std::size_t n)
+    {
+        return *std::max_element(data, data + n);
+    }
+
+#if defined(__AVX__)
+
+    static double horizontalSum(__m256d v)
+    {
+        const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    }
+
+    static double sumOf(const float* data, std::size_t n)
+    {
+        __m256d low = _mm256_setzero_pd();
+        __m256d high = _mm256_setzero_pd();
+        std::size_t i = 0;
+
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256 v = _mm256_loadu_ps(data + i);
+            low = _mm256_add_pd(low, _mm256_cvtps_pd(_mm256_castps256_ps128(v)));
+            high = _mm256_add_pd(high, _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1)));
+        }
+
+        double total = horizontalSum(_mm256_add_pd(low, high));
+
+        for (; i < n; ++i)
+        {
+            total += data[i];
+        }
+
+        return total;
+    }
+
+    static double sumOf(const double* data, std::size_t n)
+    {
+        __m256d a = _mm256_setzero_pd();
+        __m256d b = _mm256_setzero_pd();
+        std::size_t i = 0;
+
+        for (; i + 8 <= n; i += 8)
+        {
+            a = _mm256_add_pd(a, _mm256_loadu_pd(data + i));
+            b = _mm256_add_pd(b, _mm256_loadu_pd(data + i + 4));
+        }
+
+        double total = horizontalSum(_mm256_add_pd(a, b));
+
+        for (; i < n; ++i)
+        {
+            total += data[i];
+        }
+
+        return total;
+    }
+
+    static float minOf(const float* data, std::size_t n)
+    {
+        if (n < 8) return *std::min_element(data, data + n);
+
+        __m256 m = _mm256_loadu_ps(data);
+        std::size_t i = 8;
+
+        for (; i + 8 <= n; i += 8) m = _mm256_min_ps(m, _mm256_loadu_ps(data + i));
+
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, m);
+        float result = *std::min_element(lanes, lanes + 8);
+
+        for (; i < n; ++i) result = std::min(result, data[i]);
+        return result;
+    }
+
+    static float maxOf(const float* data, std::size_t n)
+    {
+        if (n < 8) return *std::max_element(data, data + n);
+
+        __m256 m = _mm256_loadu_ps(data);
+        std::size_t i = 8;
+
+        for (; i + 8 <= n; i += 8) m = _mm256_max_ps(m, _mm256_loadu_ps(data + i));
+
+        alignas(32) float lanes[8];
+        _mm256_store_ps(lanes, m);
+        float result = *std::max_element(lanes, lanes + 8);
+
+        for (; i < n; ++i) result = std::max(result, data[i]);
+        return result;
+    }
+
+    static double minOf(const double* data, std::size_t n)
+    {
+        if (n < 4) return *std::min_element(data, data + n);
+
+        __m256d m = _mm256_loadu_pd(data);
+        std::size_t i = 4;
+
+        for (; i + 4 <= n; i += 4) m = _mm256_min_pd(m, _mm256_loadu_pd(data + i));
+
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, m);
+        double result = *std::min_element(lanes, lanes + 4);
+
+        for (; i < n; ++i) result = std::min(result, data[i]);
+        return result;
+    }
+
+    static double maxOf(const double* data, std::size_t n)
+    {
+        if (n < 4) return *std::max_element(data, data + n);
+
+        __m256d m = _mm256_loadu_pd(data);
+        std::size_t i = 4;
+
+        for (; i + 4 <= n; i += 4) m = _mm256_max_pd(m, _mm256_loadu_pd(data + i));
+
+        alignas(32) double lanes[4];
+        _mm256_store_pd(lanes, m);
+        double result = *std::max_element(lanes, lanes + 4);
+
+        for (; i < n; ++i) result = std::max(result, data[i]);
+        return result;
+    }
+
+#elif defined(GAMEFOUNDATION_RINGBUFFER_SSE2)
+
+    static double horizontalSum(__m128d v)
+    {
+        return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+    }
+
+    static double sumOf(const float* data, std::size_t n)
+    {
+        __m128d low = _mm_setzero_pd();
+        __m128d high = _mm_setzero_pd();
+        std::size_t i = 0;
+
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128 v = _mm_loadu_ps(data + i);
+            low = _mm_add_pd(low, _mm_cvtps_pd(v));
+            high = _mm_add_pd(high, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+        }
+
+        double total = horizontalSum(_mm_add_pd(low, high));
+
+        for (; i < n; ++i)
+        {
+            total += data[i];
+        }
+
+        return total;
+    }
+
+    static double sumOf(const double* data, std::size_t n)
+    {
+        __m128d a = _mm_setzero_pd();
+        __m128d b = _mm_setzero_pd();
+        std::size_t i = 0;
+
+        for (; i + 4 <= n; i += 4)
+        {
+            a = _mm_add_pd(a, _mm_loadu_pd(data + i));
+            b = _mm_add_pd(b, _mm_loadu_pd(data + i + 2));
+        }
+
+        double total = horizontalSum(_mm_add_pd(a, b));
+
+        for (; i < n; ++i)
+        {
+            total += data[i];
+        }
+
+        return total;
+    }
+
+    static float minOf(const float* data, std::size_t n)
+    {
+        if (n < 4) return *std::min_element(data, data + n);
+
+        __m128 m = _mm_loadu_ps(data);
+        std::size_t i = 4;
+
+        for (; i + 4 <= n; i += 4) m = _mm_min_ps(m, _mm_loadu_ps(data + i));
+
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, m);
+        float result = *std::min_element(lanes, lanes + 4);
+
+        for (; i < n; ++i) result = std::min(result, data[i]);
+        return result;
+    }
+
+    static float maxOf(const float* data, std::size_t n)
+    {
+        if (n < 4) return *std::max_element(data, data + n);
+
+        __m128 m = _mm_loadu_ps(data);
+        std::size_t i = 4;
+
+        for (; i + 4 <= n; i += 4) m = _mm_max_ps(m, _mm_loadu_ps(data + i));
+
+        alignas(16) float lanes[4];
+        _mm_store_ps(lanes, m);
+        float result = *std::max_element(lanes, lanes + 4);
+
+        for (; i < n; ++i) result = std::max(result, data[i]);
+        return result;
+    }
+
+    static double minOf(const double* data, std::size_t n)
+    {
+        if (n < 2) return *std::min_element(data, data + n);
+
+        __m128d m = _mm_loadu_pd(data);
+        std::size_t i = 2;
+
+        for (; i + 2 <= n; i += 2) m = _mm_min_pd(m, _mm_loadu_pd(data + i));
+
+        double result = std::min(_mm_cvtsd_f64(m), _mm_cvtsd_f64(_mm_unpackhi_pd(m, m)));
+
+        for (; i < n; ++i) result = std::min(result, data[i]);
+        return result;
+    }
+
+    static double maxOf(const double* data, std::size_t n)
+    {
+        if (n < 2) return *std::max_element(data, data + n);
+
+        __m128d m = _mm_loadu_pd(data);
+        std::size_t i = 2;
+
+        for (; i + 2 <= n; i += 2) m = _mm_max_pd(m, _mm_loadu_pd(data + i));
+
+        double result = std::max(_mm_cvtsd_f64(m), _mm_cvtsd_f64(_mm_unpackhi_pd(m, m)));
+
+        for (; i < n; ++i) result = std::max(result, data[i]);
+        return result;
+    }
+
+#endif
+};
+
+#undef GAMEFOUNDATION_RINGBUFFER_SSE2
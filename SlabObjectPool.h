@@ -0,0 +1,135 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        /// Object Pool (Slab)
+        /// Objects are constructed in place in fixed size slabs and never move: acquire returns a stable pointer, release destroys the object
+        /// and threads its slot onto an intrusive free list (the link lives in the dead object's storage), so both are O(1) pointer operations
+        /// with no copies or moves of T, unlike ObjectPool / ObjectPoolDynamic which move whole objects in and out.
+        /// Slabs are cache line aligned and are allocated as needed, SlabSize slots at a time; memory is only returned when the pool is destroyed.
+        /// Every acquired object must be released before the pool goes away
+        template<typename T, std::size_t SlabSize = 64>
+        class SlabObjectPool
+        {
+        public:
+            static_assert(SlabSize > 0, "slabs need at least one slot");
+
+            SlabObjectPool() = default;
+            SlabObjectPool(const SlabObjectPool&) = delete;
+            SlabObjectPool& operator=(const SlabObjectPool&) = delete;
+
+            explicit SlabObjectPool(std::size_t reserveSize)
+            {
+                reserve(reserveSize);
+            }
+
+            ~SlabObjectPool()
+            {
+                assert(m_live == 0 && "objects still acquired from the pool");
+            }
+
+            /// constructs a T from args in a free slot and returns it; the pointer stays valid until release
+            template <typename... Args>
+            T* acquire(Args&&... args)
+            {
+                if (!m_freeList)
+                {
+                    addSlab();
+                }
+
+                // the link shares storage with the object, so read it first. The slot only leaves the free list once construction
+                // succeeded; if the constructor throws, the guard writes the link back over whatever it left in the storage
+                Slot* slot = m_freeList;
+                Slot* next = slot->nextFree;
+
+                struct RelinkOnThrow
+                {
+                    Slot* slot;
+                    Slot* next;
+                    ~RelinkOnThrow() { if (slot) slot->nextFree = next; }
+                } relink{ slot, next };
+
+                T* object = ::new (static_cast<void*>(slot->storage)) T(std::forward<Args>(args)...);
+                relink.slot = nullptr;
+                m_freeList = next;
+                ++m_live;
+                return object;
+            }
+
+            /// destroys an object from acquire and makes its slot available again
+            void release(T* object)
+            {
+                assert(object && m_live > 0);
+
+                object->~T();
+
+                Slot* slot = reinterpret_cast<Slot*>(object);
+                slot->nextFree = m_freeList;
+                m_freeList = slot;
+                --m_live;
+            }
+
+            /// makes sure at least reserveSize objects fit without allocating
+            void reserve(std::size_t reserveSize)
+            {
+                while (capacity() < reserveSize)
+                {
+                    addSlab();
+                }
+            }
+
+            /// objects currently acquired
+            std::size_t size() const
+            {
+                return m_live;
+            }
+
+            std::size_t capacity() const
+            {
+                return m_slabs.size() * SlabSize;
+            }
+
+        private:
+
+            union Slot
+            {
+                Slot* nextFree;
+                alignas(T) unsigned char storage[sizeof(T)];
+            };
+
+            static constexpr std::size_t slabAlignment = std::max<std::size_t>(alignof(Slot), 64);
+
+            struct alignas(slabAlignment) Slab
+            {
+                Slot slots[SlabSize];
+            };
+
+            void addSlab()
+            {
+                m_slabs.push_back(std::unique_ptr<Slab>(new Slab)); // default init: no need to zero the slots
+                Slab& slab = *m_slabs.back();
+
+                // thread back to front so the new slab is handed out in address order
+                for (std::size_t i = SlabSize; i > 0; --i)
+                {
+                    slab.slots[i - 1].nextFree = m_freeList;
+                    m_freeList = &slab.slots[i - 1];
+                }
+            }
+
+            std::vector<std::unique_ptr<Slab>> m_slabs;
+            Slot* m_freeList = nullptr;
+            std::size_t m_live = 0;
+        };
+
+    }
+}
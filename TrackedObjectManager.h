@@ -0,0 +1,155 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <vector>
+
+#include "ObjectManager.h"
+
+namespace Virtuoso
+{
+    namespace GameFoundations
+    {
+        enum class ObjectChangeKind : std::uint8_t
+        {
+            Inserted,
+            Modified,
+            Removed
+        };
+
+        template <typename HandleType>
+        struct ObjectChange
+        {
+            HandleType handle;
+            std::uint64_t frame;
+            ObjectChangeKind kind;
+        };
+
+        /// ObjectManager that logs what changed, for replication / snapshot diffs
+        /// Inserts, removes and modifyObject() calls are appended to a change log stamped with the current frame counter;
+        /// changesSince(frame) returns everything logged after a frame, so a consumer only touches objects that actually changed.
+        /// A slot is logged as Modified at most once per frame. lookupObject() is read only and isn't logged: anything that mutates an
+        /// object has to go through modifyObject(). Writes through untracked() are not logged either.
+        /// The log grows until discardChangesUpTo() is called with the oldest frame any consumer still needs
+        template <typename ObjectType,
+            template <typename, typename = std::allocator<ObjectType>> class ObjectContainer = std::deque,
+            typename HandleType = ObjectHandle
+        >
+        class TrackedObjectManager
+        {
+        public:
+            using Manager = ObjectManager<ObjectType, ObjectContainer, HandleType>;
+            using Handle = HandleType;
+            using Change = ObjectChange<HandleType>;
+
+            std::size_t size() { return objects.size(); }
+
+            /// current frame counter; changes made from now on are stamped with it
+            std::uint64_t frame() const { return currentFrame; }
+
+            /// starts a new frame and returns its number. Frames start at 1, so changesSince(0) returns the whole log
+            std::uint64_t advanceFrame()
+            {
+                return ++currentFrame;
+            }
+
+            Handle insertObject(ObjectType&& object)
+            {
+                const Handle handle = objects.insertObject(std::move(object));
+                log(handle, ObjectChangeKind::Inserted);
+
+                // a later modifyObject in the same frame adds nothing the insert didn't already say
+                markModified(handle.index);
+                return handle;
+            }
+
+            bool removeObject(const Handle& handle)
+            {
+                if (!objects.removeObject(handle))
+                {
+                    return false;
+                }
+
+                log(handle, ObjectChangeKind::Removed);
+                return true;
+            }
+
+            const ObjectType* lookupObject(const Handle& handle)
+            {
+                return objects.lookupObject(handle);
+            }
+
+            /// lookup for writing: logs the object as Modified (once per frame) and returns it, or null if the handle is stale
+            ObjectType* modifyObject(const Handle& handle)
+            {
+                ObjectType* object = objects.lookupObject(handle);
+
+                if (object && markModified(handle.index))
+                {
+                    log(handle, ObjectChangeKind::Modified);
+                }
+
+                return object;
+            }
+
+            /// changes logged in frames after frame, oldest first; valid until the next change or discard
+            /// A handle can show up more than once (e.g. Inserted then Removed); the last entry for a handle is its final state
+            std::span<const Change> changesSince(std::uint64_t frame) const
+            {
+                auto first = std::upper_bound(changes.begin(), changes.end(), frame,
+                    [](std::uint64_t f, const Change& c) { return f < c.frame; });
+
+                return { changes.data() + (first - changes.begin()), changes.size() - std::size_t(first - changes.begin()) };
+            }
+
+            /// drops log entries from frames up to and including frame, once every consumer has seen them
+            void discardChangesUpTo(std::uint64_t frame)
+            {
+                auto first = std::upper_bound(changes.begin(), changes.end(), frame,
+                    [](std::uint64_t f, const Change& c) { return f < c.frame; });
+
+                changes.erase(changes.begin(), first);
+            }
+
+            /// the wrapped manager, for bulk work that shouldn't be logged (e.g. iterating to build a full snapshot)
+            Manager& untracked() { return objects; }
+
+            void clear()
+            {
+                objects.clear();
+                changes.clear();
+                modifiedFrames.clear();
+            }
+
+        private:
+
+            void log(const Handle& handle, ObjectChangeKind kind)
+            {
+                changes.push_back({ handle, currentFrame, kind });
+            }
+
+            /// true the first time a slot is marked in the current frame
+            bool markModified(std::size_t index)
+            {
+                if (index >= modifiedFrames.size())
+                {
+                    modifiedFrames.resize(index + 1, 0u);
+                }
+
+                if (modifiedFrames[index] == currentFrame)
+                {
+                    return false;
+                }
+
+                modifiedFrames[index] = currentFrame;
+                return true;
+            }
+
+            Manager objects;
+            std::vector<Change> changes;              ///< append only, so sorted by frame
+            std::vector<std::uint64_t> modifiedFrames; ///< last frame each slot was logged as Modified (or Inserted)
+            std::uint64_t currentFrame = 1;
+        };
+    }
+}
@@ -1,4 +1,16 @@
 #pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "SlabObjectPool.h"
+
 namespace Virtuoso
 {
     namespace GameFoundations
@@ -39,5 +51,213 @@ namespace Virtuoso
 
             return eventCt - q.size(); // events processed
         }
+
+        /// Move-only void() callable stored inline in Capacity bytes: never allocates. Callables that don't fit fail to compile
+        /// (raise Capacity rather than falling back to the heap); they must also be nothrow move constructible
+        template <std::size_t Capacity = 48>
+        class InlineFunction
+        {
+            struct Ops
+            {
+                void (*invoke)(void*);
+                void (*move)(void* to, void* from); ///< move constructs into to and destroys from
+                void (*destroy)(void*);
+            };
+
+            template <typename F>
+            static constexpr Ops opsFor =
+            {
+                [](void* f) { (*static_cast<F*>(f))(); },
+                [](void* to, void* from) { ::new (to) F(std::move(*static_cast<F*>(from))); static_cast<F*>(from)->~F(); },
+                [](void* f) { static_cast<F*>(f)->~F(); }
+            };
+
+            alignas(std::max_align_t) unsigned char storage[Capacity];
+            const Ops* ops = nullptr;
+
+        public:
+
+            InlineFunction() = default;
+
+            template <typename F>
+                requires (!std::is_same_v<std::remove_cvref_t<F>, InlineFunction> && std::is_invocable_r_v<void, std::decay_t<F>&>)
+            InlineFunction(F&& f)
+            {
+                using Callable = std::decay_t<F>;
+                static_assert(sizeof(Callable) <= Capacity, "callable doesn't fit the inline storage; capture less or raise Capacity");
+                static_assert(alignof(Callable) <= alignof(std::max_align_t), "over-aligned callables aren't supported");
+                static_assert(std::is_nothrow_move_constructible_v<Callable>, "callable must be nothrow move constructible");
+
+                ::new (static_cast<void*>(storage)) Callable(std::forward<F>(f));
+                ops = &opsFor<Callable>;
+            }
+
+            InlineFunction(InlineFunction&& other) noexcept
+                : ops(other.ops)
+            {
+                if (ops)
+                {
+                    ops->move(storage, other.storage);
+                    other.ops = nullptr;
+                }
+            }
+
+            InlineFunction& operator=(InlineFunction&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset();
+
+                    if (other.ops)
+                    {
+                        other.ops->move(storage, other.storage);
+                        ops = other.ops;
+                        other.ops = nullptr;
+                    }
+                }
+
+                return *this;
+            }
+
+            InlineFunction(const InlineFunction&) = delete;
+            InlineFunction& operator=(const InlineFunction&) = delete;
+
+            ~InlineFunction()
+            {
+                reset();
+            }
+
+            void operator()()
+            {
+                ops->invoke(storage);
+            }
+
+            explicit operator bool() const
+            {
+                return ops != nullptr;
+            }
+
+            void reset()
+            {
+                if (ops)
+                {
+                    ops->destroy(storage);
+                    ops = nullptr;
+                }
+            }
+        };
+
+        /// UpdateQueue that doesn't allocate per event: payloads are InlineFunctions living in a SlabObjectPool, and the heap itself only
+        /// orders small {timestamp, sequence, payload pointer} entries, so sifting never moves a callable. The due event is popped off the
+        /// heap and its payload really moved out (priority_queue::top() is const, so UpdateQueue copies it) before it runs, which lets
+        /// payloads schedule further events. Events with equal timestamps run in the order they were scheduled.
+        /// Once reserve() covers the peak number of pending events, scheduling and dispatching allocate nothing
+        template <std::size_t InlineSize = 48, std::size_t SlabSize = 256>
+        class PooledUpdateQueue
+        {
+        public:
+            using Payload = InlineFunction<InlineSize>;
+
+            PooledUpdateQueue() = default;
+            PooledUpdateQueue(const PooledUpdateQueue&) = delete;
+            PooledUpdateQueue& operator=(const PooledUpdateQueue&) = delete;
+
+            explicit PooledUpdateQueue(std::size_t reserveSize)
+            {
+                reserve(reserveSize);
+            }
+
+            ~PooledUpdateQueue()
+            {
+                clear();
+            }
+
+            /// queues f to run once processUpdateEvents is called with a time at or past timestamp
+            template <typename F>
+            void schedule(double timestamp, F&& f)
+            {
+                heap.push_back({ timestamp, nextSequence++, payloads.acquire(std::forward<F>(f)) });
+                std::push_heap(heap.begin(), heap.end(), later);
+            }
+
+            /// runs every event due at time t, earliest first, including ones scheduled by those events; returns how many ran
+            int process(double t)
+            {
+                int processed = 0;
+
+                while (!heap.empty() && heap.front().timestamp <= t)
+                {
+                    std::pop_heap(heap.begin(), heap.end(), later);
+                    Payload* slot = heap.back().payload;
+                    heap.pop_back();
+
+                    Payload payload = std::move(*slot);
+                    payloads.release(slot);
+
+                    payload();
+                    ++processed;
+                }
+
+                return processed;
+            }
+
+            /// timestamp of the next event due; the queue must not be empty
+            double nextTimestamp() const
+            {
+                return heap.front().timestamp;
+            }
+
+            std::size_t size() const
+            {
+                return heap.size();
+            }
+
+            bool empty() const
+            {
+                return heap.empty();
+            }
+
+            void reserve(std::size_t reserveSize)
+            {
+                heap.reserve(reserveSize);
+                payloads.reserve(reserveSize);
+            }
+
+            /// drops every pending event without running it
+            void clear()
+            {
+                for (const Entry& entry : heap)
+                {
+                    payloads.release(entry.payload);
+                }
+
+                heap.clear();
+            }
+
+        private:
+
+            struct Entry
+            {
+                double timestamp;
+                std::uint64_t sequence;
+                Payload* payload;
+            };
+
+            /// heap order: std heaps keep the greatest element in front, so "greater" here means due earlier
+            static bool later(const Entry& a, const Entry& b)
+            {
+                return a.timestamp > b.timestamp || (a.timestamp == b.timestamp && a.sequence > b.sequence);
+            }
+
+            std::vector<Entry> heap;
+            SlabObjectPool<Payload, SlabSize> payloads;
+            std::uint64_t nextSequence = 0;
+        };
+
+        template <std::size_t InlineSize, std::size_t SlabSize>
+        inline int processUpdateEvents(double t, PooledUpdateQueue<InlineSize, SlabSize>& q)
+        {
+            return q.process(t);
+        }
     }
 }
\ No newline at end of file
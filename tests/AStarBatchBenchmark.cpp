@@ -0,0 +1,79 @@
+// AStarBatchPool scaling: every worker count gives the same results as a single worker; prints batch time per worker count
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "AStarBatch.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+int main(int argc, char** argv)
+{
+    const int repeats = repeatFactor(argc, argv);
+    const GridGraph grid = randomGrid(128, 128, 15, 3);
+    const GridOctileDistance octile;
+
+    std::mt19937 rng(5);
+    std::vector<AStarPathRequest<GridGraph::NodeHandle>> requests;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        requests.push_back({ GridGraph::NodeHandle(rng() % grid.size()), GridGraph::NodeHandle(rng() % grid.size()) });
+    }
+
+    const std::size_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::size_t> workerCounts = { 1, 2, 4 };
+
+    if (hardwareThreads > 4)
+    {
+        workerCounts.push_back(hardwareThreads);
+    }
+
+    std::printf("128x128 grid, %zu requests per batch, %zu hardware threads\n", requests.size(), hardwareThreads);
+
+    std::vector<AStarPathResult<GridGraph::NodeHandle>> reference;
+    double singleWorkerMs = 0.0;
+
+    for (std::size_t workers : workerCounts)
+    {
+        AStarBatchPool<GridGraph> pool(workers);
+        std::vector<AStarPathResult<GridGraph::NodeHandle>> results(requests.size());
+
+        const double ms = bestTimeMs(2 * repeats, [&]
+        {
+            pool.run(grid, std::span<const AStarPathRequest<GridGraph::NodeHandle>>(requests), std::span(results), octile, octile);
+        });
+
+        if (workers == 1)
+        {
+            reference = results;
+            singleWorkerMs = ms;
+        }
+
+        for (std::size_t i = 0; i < requests.size(); ++i)
+        {
+            CHECK(results[i].status == reference[i].status);
+            CHECK(results[i].path.empty() == reference[i].path.empty());
+
+            if (!results[i].path.empty())
+            {
+                CHECK(results[i].path.front() == requests[i].start && results[i].path.back() == requests[i].target);
+                CHECK(std::abs(pathCost(grid, std::span<const GridGraph::NodeHandle>(results[i].path), octile)
+                    - pathCost(grid, std::span<const GridGraph::NodeHandle>(reference[i].path), octile)) < 1e-9);
+            }
+        }
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "batch, %zu worker(s)", workers);
+        report(name, ms, requests.size());
+        std::printf("    speedup over 1 worker: %.2fx\n", singleWorkerMs / ms);
+    }
+
+    // an empty batch returns without waking the workers
+    AStarBatchPool<GridGraph> pool(2);
+    pool.run(grid, std::span<const AStarPathRequest<GridGraph::NodeHandle>>(), std::span<AStarPathResult<GridGraph::NodeHandle>>(), octile, octile);
+
+    return 0;
+}
@@ -0,0 +1,104 @@
+// A reused AStarContext makes no heap allocations once its buffers have grown, and finds the same paths as the allocating AStar
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "AStar.h"
+#include "CountingAllocator.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    using Query = std::pair<GridGraph::NodeHandle, GridGraph::NodeHandle>;
+
+    /// runs every query on context and returns how many heap allocations that took
+    template <typename Context>
+    std::size_t allocationsFor(Context& context, const GridGraph& grid, const std::vector<Query>& queries)
+    {
+        const GridOctileDistance octile;
+        const std::size_t before = allocations();
+
+        for (const auto& [start, target] : queries)
+        {
+            AStar(context, grid, start, target, octile, octile);
+        }
+
+        return allocations() - before;
+    }
+}
+
+int main()
+{
+    const GridGraph grid = randomGrid(128, 128, 20, 3);
+    const GridOctileDistance octile;
+
+    std::mt19937 rng(5);
+    std::vector<Query> queries;
+
+    for (int i = 0; i < 300; ++i)
+    {
+        queries.emplace_back(GridGraph::NodeHandle(rng() % grid.size()), GridGraph::NodeHandle(rng() % grid.size()));
+    }
+
+    queries.emplace_back(0u, 0u);                                 // single node path
+    queries.emplace_back(0u, GridGraph::NodeHandle(grid.size())); // invalid target
+
+    AStarContext<GridGraph> context;
+
+    // same costs as the allocating overload, and a path runs from start to target
+    for (const auto& [start, target] : queries)
+    {
+        AStarResult<GridGraph::NodeHandle> reference = AStar(grid, start, target, octile, octile);
+        const auto path = AStar(context, grid, start, target, octile, octile);
+
+        if (!grid.is_valid_handle(target))
+        {
+            CHECK(path.empty());
+            continue;
+        }
+
+        if (start == target)
+        {
+            CHECK(path.size() == 1 && path[0] == start);
+            continue;
+        }
+
+        CHECK(reference.empty() == path.empty());
+
+        if (!path.empty())
+        {
+            std::vector<GridGraph::NodeHandle> referencePath;
+
+            for (; !reference.empty(); reference.pop())
+            {
+                referencePath.push_back(reference.top());
+            }
+
+            CHECK(path.front() == start && path.back() == target);
+            CHECK(std::abs(pathCost(grid, std::span<const GridGraph::NodeHandle>(referencePath), octile) - pathCost(grid, path, octile)) < 1e-9);
+        }
+    }
+
+    // the pass above grew the buffers; repeating the queries must not touch the heap
+    const std::size_t denseAllocations = allocationsFor(context, grid, queries);
+    std::printf("DenseTraversalRecords context: %zu allocations for %zu queries\n", denseAllocations, queries.size());
+    CHECK(denseAllocations == 0);
+
+    // a fresh context allocates while it grows, then stops; reserve() takes care of the open list and path up front
+    AStarContext<GridGraph> reserved;
+    reserved.reserve(grid.size(), grid.size());
+    allocationsFor(reserved, grid, queries);
+    CHECK(allocationsFor(reserved, grid, queries) == 0);
+
+    // hash map records only stop allocating once every node a query visits has been seen by an earlier one
+    AStarContext<GridGraph, MapTraversalRecords<GridGraph>> mapContext;
+    const std::size_t firstMapPass = allocationsFor(mapContext, grid, queries);
+    const std::size_t secondMapPass = allocationsFor(mapContext, grid, queries);
+    std::printf("MapTraversalRecords context: %zu allocations on the first pass, %zu on the second\n", firstMapPass, secondMapPass);
+    CHECK(firstMapPass > 0);
+    CHECK(secondMapPass == 0);
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+// Dense-index traversal records against the unordered_map ones: same path costs, and how much faster the flat arrays are
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "AStar.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    std::vector<GridGraph::NodeHandle> toVector(AStarResult<GridGraph::NodeHandle> result)
+    {
+        std::vector<GridGraph::NodeHandle> path;
+
+        while (!result.empty())
+        {
+            path.push_back(result.top());
+            result.pop();
+        }
+
+        return path;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int repeats = repeatFactor(argc, argv);
+    const GridGraph grid = randomGrid(128, 128, 20, 3);
+    const GridOctileDistance octile;
+
+    std::mt19937 rng(5);
+    std::vector<std::pair<GridGraph::NodeHandle, GridGraph::NodeHandle>> queries;
+
+    for (int i = 0; i < 200; ++i)
+    {
+        queries.emplace_back(GridGraph::NodeHandle(rng() % grid.size()), GridGraph::NodeHandle(rng() % grid.size()));
+    }
+
+    // both variants find optimal paths, so the costs must agree even where the paths differ
+    DenseTraversalRecords<GridGraph> records;
+    int found = 0;
+
+    for (const auto& [start, target] : queries)
+    {
+        const auto mapPath = toVector(AStar(grid, start, target, octile, octile));
+        const auto densePath = toVector(AStar(records, grid, start, target, octile, octile));
+
+        CHECK(mapPath.empty() == densePath.empty());
+
+        if (!densePath.empty())
+        {
+            CHECK(densePath.front() == start && densePath.back() == target);
+            CHECK(std::abs(pathCost(grid, std::span<const GridGraph::NodeHandle>(mapPath), octile)
+                - pathCost(grid, std::span<const GridGraph::NodeHandle>(densePath), octile)) < 1e-9);
+            ++found;
+        }
+    }
+
+    CHECK(found > 0);
+
+    std::size_t sink = 0;
+
+    const double mapMs = bestTimeMs(3 * repeats, [&]
+    {
+        for (const auto& [start, target] : queries)
+        {
+            sink += AStar(grid, start, target, octile, octile).size();
+        }
+    });
+
+    const double denseMs = bestTimeMs(3 * repeats, [&]
+    {
+        for (const auto& [start, target] : queries)
+        {
+            sink += AStar(records, grid, start, target, octile, octile).size();
+        }
+    });
+
+    AStarContext<GridGraph, MapTraversalRecords<GridGraph>> mapContext;
+    AStarContext<GridGraph> denseContext;
+
+    const double mapContextMs = bestTimeMs(3 * repeats, [&]
+    {
+        for (const auto& [start, target] : queries)
+        {
+            sink += AStar(mapContext, grid, start, target, octile, octile).size();
+        }
+    });
+
+    const double denseContextMs = bestTimeMs(3 * repeats, [&]
+    {
+        for (const auto& [start, target] : queries)
+        {
+            sink += AStar(denseContext, grid, start, target, octile, octile).size();
+        }
+    });
+
+    std::printf("128x128 grid, %zu queries, %d with a path\n", queries.size(), found);
+    report("AStar, unordered_map records", mapMs, queries.size());
+    report("AStar, DenseTraversalRecords", denseMs, queries.size());
+    report("AStarContext, MapTraversalRecords", mapContextMs, queries.size());
+    report("AStarContext, DenseTraversalRecords", denseContextMs, queries.size());
+    std::printf("dense speedup: %.2fx\n", mapMs / denseMs);
+    CHECK(sink > 0);
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Open list policies: the binary heap, indexed d-ary heaps and the radix heap all find equally cheap paths; prints time and push counts
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "AStar.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    using Query = std::pair<GridGraph::NodeHandle, GridGraph::NodeHandle>;
+
+    /// integer costs for the radix heap: a diagonal step costs as much as two straight ones, so Manhattan distance is consistent
+    struct ManhattanCost
+    {
+        double operator()(const GridGraph& grid, GridGraph::NodeHandle a, GridGraph::NodeHandle b) const
+        {
+            return double(std::abs(grid.x_of(a) - grid.x_of(b)) + std::abs(grid.y_of(a) - grid.y_of(b)));
+        }
+    };
+
+    template <typename Context, typename CostFn>
+    std::vector<double> solve(Context& context, const GridGraph& grid, const std::vector<Query>& queries, CostFn cost, std::size_t& pushes)
+    {
+        std::vector<double> costs;
+        pushes = 0;
+
+        for (const auto& [start, target] : queries)
+        {
+            const auto path = AStar(context, grid, start, target, cost, cost);
+            costs.push_back(path.empty() ? -1.0 : pathCost(grid, path, cost));
+            pushes += context.stats.pushes;
+        }
+
+        return costs;
+    }
+
+    template <typename Context, typename CostFn>
+    void benchmark(const char* name, Context& context, const GridGraph& grid, const std::vector<Query>& queries, CostFn cost,
+        const std::vector<double>& expected, int repeats)
+    {
+        std::size_t pushes = 0;
+        const std::vector<double> costs = solve(context, grid, queries, cost, pushes);
+
+        for (std::size_t i = 0; i < queries.size(); ++i)
+        {
+            CHECK(std::abs(costs[i] - expected[i]) < 1e-9);
+        }
+
+        const double ms = bestTimeMs(2 * repeats, [&] { solve(context, grid, queries, cost, pushes); });
+        report(name, ms, queries.size());
+        std::printf("    %zu pushes\n", pushes);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int repeats = repeatFactor(argc, argv);
+    const GridGraph grid = randomGrid(150, 150, 25, 9);
+    const GridOctileDistance octile;
+    const ManhattanCost manhattan;
+
+    std::mt19937 rng(9);
+    std::vector<Query> queries;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        queries.emplace_back(GridGraph::NodeHandle(rng() % grid.size()), GridGraph::NodeHandle(rng() % grid.size()));
+    }
+
+    using Records = DenseTraversalRecords<GridGraph>;
+
+    AStarContext<GridGraph, Records, BinaryHeapOpenList<GridGraph>> binary;
+    AStarContext<GridGraph, Records, IndexedDaryHeapOpenList<GridGraph, 2>> dary2;
+    AStarContext<GridGraph, Records, IndexedDaryHeapOpenList<GridGraph, 4>> dary4;
+    AStarContext<GridGraph, Records, IndexedDaryHeapOpenList<GridGraph, 8>> dary8;
+    AStarContext<GridGraph, Records, RadixHeapOpenList<GridGraph>> radix;
+
+    std::size_t pushes = 0;
+    const std::vector<double> octileCosts = solve(binary, grid, queries, octile, pushes);
+    const std::vector<double> manhattanCosts = solve(binary, grid, queries, manhattan, pushes);
+
+    std::printf("150x150 grid, 25%% walls, %zu queries\n", queries.size());
+    std::printf("octile costs:\n");
+    benchmark("BinaryHeapOpenList", binary, grid, queries, octile, octileCosts, repeats);
+    benchmark("IndexedDaryHeapOpenList<2>", dary2, grid, queries, octile, octileCosts, repeats);
+    benchmark("IndexedDaryHeapOpenList<4>", dary4, grid, queries, octile, octileCosts, repeats);
+    benchmark("IndexedDaryHeapOpenList<8>", dary8, grid, queries, octile, octileCosts, repeats);
+
+    // decrease-key keeps every node in the heap once, so no stale entries are ever popped
+    for (const auto& [start, target] : queries)
+    {
+        AStar(dary4, grid, start, target, octile, octile);
+        CHECK(dary4.stats.duplicatePops == 0);
+    }
+
+    std::printf("integer costs:\n");
+    benchmark("BinaryHeapOpenList", binary, grid, queries, manhattan, manhattanCosts, repeats);
+    benchmark("IndexedDaryHeapOpenList<4>", dary4, grid, queries, manhattan, manhattanCosts, repeats);
+    benchmark("RadixHeapOpenList", radix, grid, queries, manhattan, manhattanCosts, repeats);
+
+    return 0;
+}
@@ -0,0 +1,237 @@
+// CSRGraph against the vector-of-vectors adjacency list it replaces: same A* results, memory footprint, edge sweep and A* times
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "AStar.h"
+#include "CSRGraph.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    /// the layout CSRGraph replaces: one heap allocated neighbor vector and cost vector per node
+    struct AdjacencyListGraph
+    {
+        using NodeType = std::uint8_t;
+        using NodeHandle = std::uint32_t;
+        using NeighborIterator = std::vector<std::uint32_t>::const_iterator;
+
+        std::vector<NodeType> nodes;
+        std::vector<std::vector<std::uint32_t>> neighbors;
+        std::vector<std::vector<float>> costs;
+
+        const NodeType& operator[](NodeHandle node) const { return nodes[node]; }
+        NeighborIterator neighbor_begin(NodeHandle node) const { return neighbors[node].begin(); }
+        NeighborIterator neighbor_end(NodeHandle node) const { return neighbors[node].end(); }
+        size_t size() const { return nodes.size(); }
+        bool is_valid_handle(NodeHandle node) const { return node < nodes.size(); }
+        std::size_t index_of(NodeHandle node) const { return node; }
+
+        double edge_cost(NodeHandle from, NodeHandle to) const
+        {
+            for (std::size_t i = 0; i < neighbors[from].size(); ++i)
+            {
+                if (neighbors[from][i] == to)
+                {
+                    return costs[from][i];
+                }
+            }
+
+            return INFINITY;
+        }
+    };
+
+    /// reads the adjacency list's cost vector at the edge AStar() is relaxing, as CSREdgeCostFunction does for CSRGraph
+    struct AdjacencyEdgeCost
+    {
+        using reads_edge_costs = std::true_type;
+
+        double operator()(const AdjacencyListGraph& g, std::uint32_t from, AdjacencyListGraph::NeighborIterator edge) const
+        {
+            return g.costs[from][std::size_t(edge - g.neighbor_begin(from))];
+        }
+
+        double operator()(const AdjacencyListGraph& g, std::uint32_t from, std::uint32_t to) const
+        {
+            return g.edge_cost(from, to);
+        }
+    };
+
+    static_assert(DenseIndexedGraph<AdjacencyListGraph>);
+    static_assert(DenseIndexedGraph<CSRGraph<std::uint8_t>>);
+    static_assert(DenseIndexedGraph<CSRGraphView<std::uint8_t>>);
+    static_assert(EdgeCostFunction<CSREdgeCostFunction, CSRGraph<std::uint8_t>>);
+    static_assert(EdgeCostFunction<CSREdgeCostFunction, CSRGraphView<std::uint8_t>>);
+    static_assert(EdgeCostFunction<AdjacencyEdgeCost, AdjacencyListGraph>);
+
+    /// cost of the edge an iterator points at, read from the slot parallel to it (no row search in either layout)
+    double edgeCost(const AdjacencyListGraph& graph, std::uint32_t from, AdjacencyListGraph::NeighborIterator edge)
+    {
+        return graph.costs[from][std::size_t(edge - graph.neighbor_begin(from))];
+    }
+
+    template <typename NodeType>
+    double edgeCost(const CSRGraph<NodeType>& graph, std::uint32_t, typename CSRGraph<NodeType>::NeighborIterator edge)
+    {
+        return double(graph.edge_cost(edge));
+    }
+
+    /// sums the cost of every edge, walking each node's row in order
+    template <typename G>
+    double edgeSweep(const G& graph)
+    {
+        double total = 0.0;
+
+        for (typename G::NodeHandle n = 0; n < graph.size(); ++n)
+        {
+            for (auto it = graph.neighbor_begin(n); it != graph.neighbor_end(n); ++it)
+            {
+                total += edgeCost(graph, n, it);
+            }
+        }
+
+        return total;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int repeats = repeatFactor(argc, argv);
+    const GridGraph grid = randomGrid(200, 200, 25, 5);
+    const GridOctileDistance octile;
+
+    std::vector<GridGraph::NodeHandle> handles(grid.size());
+    std::iota(handles.begin(), handles.end(), 0u);
+
+    const auto csr = CSRGraph<std::uint8_t>::fromGraph(grid, std::span<const GridGraph::NodeHandle>(handles), [](GridGraph::NodeHandle h) { return h; }, octile);
+    const auto view = csr.view();
+
+    AdjacencyListGraph adjacency;
+    adjacency.nodes.resize(grid.size());
+    adjacency.neighbors.resize(grid.size());
+    adjacency.costs.resize(grid.size());
+
+    for (GridGraph::NodeHandle n = 0; n < grid.size(); ++n)
+    {
+        adjacency.nodes[n] = grid[n];
+
+        for (auto it = grid.neighbor_begin(n); it != grid.neighbor_end(n); ++it)
+        {
+            adjacency.neighbors[n].push_back(*it);
+            adjacency.costs[n].push_back(float(octile(grid, n, *it)));
+        }
+    }
+
+    CHECK(csr.size() == grid.size());
+    CHECK(view.size() == csr.size() && view.edge_count() == csr.edge_count());
+
+    // same rows in the same order as the source graph
+    std::size_t edges = 0;
+
+    for (GridGraph::NodeHandle n = 0; n < grid.size(); ++n)
+    {
+        const auto row = csr.neighbors_of(n);
+        CHECK(row.size() == adjacency.neighbors[n].size());
+        CHECK(std::equal(row.begin(), row.end(), adjacency.neighbors[n].begin()));
+        edges += row.size();
+    }
+
+    CHECK(edges == csr.edge_count());
+
+    // small hand built graph: rows, costs and missing edges
+    std::vector<CSREdge<>> smallEdges = { { 0, 1, 2.f }, { 2, 0, 1.f }, { 0, 2, 5.f } };
+    CSRGraph<int> small({ 1, 2, 3 }, smallEdges);
+    CHECK(small.degree(0) == 2 && small.degree(1) == 0 && small.degree(2) == 1);
+    CHECK(small.edge_cost(0, 2) == 5.0 && small.edge_cost(2, 0) == 1.0 && std::isinf(small.edge_cost(1, 0)));
+
+    CSRGraph<int> unweighted({ 1, 2 }, std::span<const CSREdge<>>(smallEdges.data(), 1), false);
+    CHECK(!unweighted.has_edge_costs() && unweighted.edge_cost(0, 1) == 1.0);
+
+    // A* over all three layouts finds paths of the same length
+    auto heuristic = [&](const auto&, std::uint32_t a, std::uint32_t b) { return octile(grid, a, b); };
+    const AdjacencyEdgeCost adjacencyCost;
+
+    AStarContext<GridGraph> gridContext;
+    AStarContext<AdjacencyListGraph> adjacencyContext;
+    AStarContext<CSRGraph<std::uint8_t>> csrContext;
+
+    std::mt19937 rng(5);
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> queries;
+
+    for (int i = 0; i < 60; ++i)
+    {
+        queries.emplace_back(std::uint32_t(rng() % grid.size()), std::uint32_t(rng() % grid.size()));
+    }
+
+    for (const auto& [start, target] : queries)
+    {
+        const auto reference = AStar(gridContext, grid, start, target, octile, octile);
+        const double referenceCost = pathCost(grid, reference, octile);
+        const auto a = AStar(adjacencyContext, adjacency, start, target, adjacencyCost, heuristic);
+        CHECK(a.empty() == reference.empty() && std::abs(pathCost(grid, a, octile) - referenceCost) < 1e-4);
+        const auto c = AStar(csrContext, csr, start, target, CSREdgeCostFunction{}, heuristic);
+        CHECK(c.empty() == reference.empty() && std::abs(pathCost(grid, c, octile) - referenceCost) < 1e-4);
+    }
+
+    const CSRGraphFootprint csrBytes = csr.footprint();
+    const CSRGraphFootprint adjacencyBytes = csr.adjacencyListFootprint();
+    CHECK(csrBytes.total() < adjacencyBytes.total());
+
+    std::printf("200x200 grid, %zu nodes, %zu edges\n", csr.size(), csr.edge_count());
+    std::printf("footprint: CSR %zu bytes, adjacency list %zu bytes (%.2fx)\n", csrBytes.total(), adjacencyBytes.total(),
+        double(adjacencyBytes.total()) / double(csrBytes.total()));
+
+    // the cost read through the edge iterator is the cost of that edge
+    for (GridGraph::NodeHandle n = 0; n < grid.size(); ++n)
+    {
+        for (auto it = csr.neighbor_begin(n); it != csr.neighbor_end(n); ++it)
+        {
+            CHECK(CSREdgeCostFunction{}(csr, n, it) == csr.edge_cost(n, *it));
+        }
+    }
+
+    CHECK(std::abs(edgeSweep(adjacency) - edgeSweep(csr)) < 1e-3 * edgeSweep(csr));
+
+    double sink = 0.0;
+    const double adjacencySweepMs = bestTimeMs(5 * repeats, [&] { sink += edgeSweep(adjacency); });
+    const double csrSweepMs = bestTimeMs(5 * repeats, [&] { sink += edgeSweep(csr); });
+    report("edge sweep, adjacency list", adjacencySweepMs, csr.edge_count());
+    report("edge sweep, CSRGraph", csrSweepMs, csr.edge_count());
+
+    const double gridMs = bestTimeMs(2 * repeats, [&]
+    {
+        for (const auto& [start, target] : queries)
+        {
+            sink += double(AStar(gridContext, grid, start, target, octile, octile).size());
+        }
+    });
+
+    const double adjacencyMs = bestTimeMs(2 * repeats, [&]
+    {
+        for (const auto& [start, target] : queries)
+        {
+            sink += double(AStar(adjacencyContext, adjacency, start, target, adjacencyCost, heuristic).size());
+        }
+    });
+
+    const double csrMs = bestTimeMs(2 * repeats, [&]
+    {
+        for (const auto& [start, target] : queries)
+        {
+            sink += double(AStar(csrContext, csr, start, target, CSREdgeCostFunction{}, heuristic).size());
+        }
+    });
+
+    report("A*, GridGraph", gridMs, queries.size());
+    report("A*, adjacency list", adjacencyMs, queries.size());
+    report("A*, CSRGraph", csrMs, queries.size());
+    CHECK(sink > 0.0);
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+// ConcurrentObjectManager under concurrent inserts, removes and lookups from several threads
+#include <atomic>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentObjectManager.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    /// fields that must always agree; a torn or recycled object breaks the invariant
+    struct Payload
+    {
+        std::uint64_t value;
+        std::uint64_t inverse;
+        std::string text;
+
+        explicit Payload(std::uint64_t v) : value(v), inverse(~v), text(std::to_string(v)) {}
+
+        bool consistent() const
+        {
+            return inverse == ~value && text == std::to_string(value);
+        }
+    };
+
+    constexpr int threadCount = 8;
+
+    /// holds threads until all of them exist, then lets them go together
+    class StartGate
+    {
+    public:
+        void wait()
+        {
+            arrived.fetch_add(1);
+
+            while (arrived.load() < threadCount)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+    private:
+        std::atomic<int> arrived{0};
+    };
+
+    /// gives up the time slice now and then, so the threads interleave even on a single core
+    void maybeYield(int i)
+    {
+        if (i % 64 == 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /// every thread inserts, removes and looks up its own objects while probing random foreign handles
+    void mixedWorkload(ConcurrentObjectManager<Payload, 6>& manager)
+    {
+        for (int frame = 0; frame < 10; ++frame)
+        {
+            StartGate gate;
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < threadCount; ++t)
+            {
+                threads.emplace_back([&manager, &gate, t, frame]
+                {
+                    std::mt19937 rng(unsigned(t * 1000 + frame));
+                    std::vector<std::pair<ObjectHandle, std::uint64_t>> mine;
+                    gate.wait();
+
+                    for (int i = 0; i < 3000; ++i)
+                    {
+                        maybeYield(i);
+                        const unsigned r = rng() % 4;
+
+                        if (r < 2 || mine.empty())
+                        {
+                            const std::uint64_t v = rng();
+                            const ObjectHandle h = manager.insertObject(Payload(v));
+                            CHECK(h.value != 0);
+                            mine.emplace_back(h, v);
+                        }
+                        else if (r == 2)
+                        {
+                            const std::size_t k = rng() % mine.size();
+                            CHECK(manager.removeObject(mine[k].first));
+                            CHECK(!manager.removeObject(mine[k].first));
+                            CHECK(manager.lookupObject(mine[k].first) == nullptr);
+                            mine[k] = mine.back();
+                            mine.pop_back();
+                        }
+                        else
+                        {
+                            const auto& [h, v] = mine[rng() % mine.size()];
+                            const Payload* p = manager.lookupObject(h);
+                            CHECK(p && p->value == v && p->consistent());
+
+                            // another thread's object, or nothing; never a broken one
+                            if (const Payload* other = manager.lookupObject(ObjectHandle(std::uint32_t(rng()))))
+                            {
+                                CHECK(other->consistent());
+                            }
+                        }
+                    }
+
+                    for (const auto& entry : mine)
+                    {
+                        CHECK(manager.removeObject(entry.first));
+                    }
+                });
+            }
+
+            for (std::thread& t : threads)
+            {
+                t.join();
+            }
+
+            CHECK(manager.size() == 0);
+            manager.reclaim();
+        }
+    }
+
+    /// all threads race to remove the same handles while others read them: each handle is removed exactly once,
+    /// and a pointer from lookupObject stays readable until reclaim()
+    void removeRace(ConcurrentObjectManager<Payload, 6>& manager)
+    {
+        constexpr int objectCount = 20000;
+        std::vector<ObjectHandle> handles;
+
+        for (int i = 0; i < objectCount; ++i)
+        {
+            handles.push_back(manager.insertObject(Payload(std::uint64_t(i))));
+        }
+
+        std::atomic<int> removed{0};
+        StartGate gate;
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&, t]
+            {
+                gate.wait();
+
+                for (int i = 0; i < objectCount; ++i)
+                {
+                    maybeYield(i);
+                    const ObjectHandle& h = handles[(i + t * 997) % objectCount];
+
+                    if (t % 2)
+                    {
+                        if (const Payload* p = manager.lookupObject(h))
+                        {
+                            CHECK(p->consistent());
+                        }
+                    }
+                    else if (manager.removeObject(h))
+                    {
+                        removed.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            });
+        }
+
+        for (std::thread& t : threads)
+        {
+            t.join();
+        }
+
+        CHECK(removed.load() == objectCount);
+        CHECK(manager.size() == 0);
+        manager.reclaim();
+
+        // reused slots come back with a new version, so none of the old handles resolve
+        std::vector<ObjectHandle> fresh;
+
+        for (int i = 0; i < objectCount; ++i)
+        {
+            fresh.push_back(manager.insertObject(Payload(std::uint64_t(i))));
+        }
+
+        for (int i = 0; i < objectCount; ++i)
+        {
+            CHECK(manager.lookupObject(handles[i]) == nullptr);
+            CHECK(manager.lookupObject(fresh[i])->value == std::uint64_t(i));
+            CHECK(manager.removeObject(fresh[i]));
+        }
+
+        manager.reclaim();
+    }
+}
+
+int main()
+{
+    ConcurrentObjectManager<Payload, 6> manager;
+
+    // unknown chunks and null handles don't resolve
+    CHECK(manager.lookupObject(ObjectHandle(0u)) == nullptr);
+    CHECK(!manager.removeObject(ObjectHandle(0x00FFFFFFu)));
+
+    mixedWorkload(manager);
+    removeRace(manager);
+
+    CHECK(manager.size() == 0);
+    std::printf("ok\n");
+    return 0;
+}
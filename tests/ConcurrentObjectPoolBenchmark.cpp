@@ -0,0 +1,186 @@
+// ConcurrentObjectPool against a mutex-guarded ObjectPoolDynamic: objects come out initialized and held by one thread at a time,
+// the Initializer runs a bounded number of times, and acquire / release throughput is timed from 1 up to 32 threads
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentObjectPool.h"
+#include "ObjectPoolDynamic.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    /// a heap buffer per object, so a pool handing one object to two threads shows up as a shared owner slot
+    struct Particle
+    {
+        std::vector<std::uint32_t> state;   ///< [0] marks initialization, [1] the owning thread (0 while pooled)
+    };
+
+    struct ParticleInitializer
+    {
+        std::atomic<std::size_t>* created;
+
+        Particle operator()() const
+        {
+            created->fetch_add(1, std::memory_order_relaxed);
+            return Particle{ std::vector<std::uint32_t>{ 0xC0FFEEu, 0u, 0u, 0u } };
+        }
+    };
+
+    constexpr std::size_t expansionSize = 16;
+    constexpr std::size_t magazineSize = 32;
+    constexpr std::size_t magazineCount = 256;
+    constexpr std::size_t maxHeld = 64;
+    constexpr int operationsPerThread = 100000;
+
+    using Pool = ConcurrentObjectPool<Particle, ParticleInitializer, expansionSize, magazineSize>;
+    using LockedPool = ObjectPoolDynamic<Particle, ParticleInitializer, expansionSize>;
+
+    /// holds threads until all of them exist, then lets them go together
+    class StartGate
+    {
+    public:
+        explicit StartGate(int threadCount) : threadCount(threadCount) {}
+
+        void wait()
+        {
+            arrived.fetch_add(1);
+
+            while (arrived.load() < threadCount)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+    private:
+        const int threadCount;
+        std::atomic<int> arrived{0};
+    };
+
+    /// the same random acquire / release pattern on every thread, holding at most maxHeld objects; acquire and release are
+    /// whatever the pool under test does, and every acquired object is checked to be initialized and unowned
+    template <typename Acquire, typename Release>
+    void churn(std::uint32_t thread, Acquire&& acquire, Release&& release)
+    {
+        std::mt19937 rng(thread);
+        std::vector<Particle> held;
+        held.reserve(maxHeld);
+
+        for (int i = 0; i < operationsPerThread; ++i)
+        {
+            // gives up the time slice now and then, so the threads interleave even on a single core
+            if (i % 256 == 0)
+            {
+                std::this_thread::yield();
+            }
+
+            if ((held.empty() || rng() % 2) && held.size() < maxHeld)
+            {
+                held.emplace_back();
+                CHECK(acquire(held.back()));
+                std::vector<std::uint32_t>& state = held.back().state;
+                CHECK(state.size() == 4 && state[0] == 0xC0FFEEu && state[1] == 0u);
+                state[1] = thread + 1;
+            }
+            else
+            {
+                Particle& p = held[rng() % held.size()];
+                CHECK(p.state[1] == thread + 1);
+                p.state[1] = 0u;
+                release(std::move(p));
+                p = std::move(held.back());
+                held.pop_back();
+            }
+        }
+
+        for (Particle& p : held)
+        {
+            p.state[1] = 0u;
+            release(std::move(p));
+        }
+    }
+
+    template <typename Body>
+    double runThreads(int threadCount, int repeats, Body body)
+    {
+        return bestTimeMs(repeats, [&]
+        {
+            StartGate gate(threadCount);
+            std::vector<std::thread> threads;
+
+            for (int t = 0; t < threadCount; ++t)
+            {
+                threads.emplace_back([&, t]
+                {
+                    body(std::uint32_t(t), gate);
+                });
+            }
+
+            for (std::thread& t : threads)
+            {
+                t.join();
+            }
+        });
+    }
+
+    void run(int threadCount, int repeats)
+    {
+        std::atomic<std::size_t> created{0};
+        Pool pool(ParticleInitializer{ &created }, 0, magazineCount);
+
+        const double concurrentMs = runThreads(threadCount, repeats, [&](std::uint32_t t, StartGate& gate)
+        {
+            Pool::Cache cache(pool);
+            gate.wait();
+            churn(t, [&](Particle& p) { return cache.acquire(p); }, [&](Particle&& p) { cache.release(std::move(p)); });
+        });
+
+        // every object exists in a thread's hands, a magazine, or the backing pool, which only grows when it runs dry
+        const std::size_t threads = std::size_t(threadCount);
+        CHECK(created.load() <= threads * maxHeld + (magazineCount + threads) * magazineSize + threads * expansionSize);
+
+        std::atomic<std::size_t> lockedCreated{0};
+        LockedPool lockedPool(ParticleInitializer{ &lockedCreated });
+        std::mutex mutex;
+
+        const double lockedMs = runThreads(threadCount, repeats, [&](std::uint32_t t, StartGate& gate)
+        {
+            gate.wait();
+            churn(t,
+                [&](Particle& p) { std::lock_guard<std::mutex> lock(mutex); return lockedPool.acquire(p); },
+                [&](Particle&& p) { std::lock_guard<std::mutex> lock(mutex); lockedPool.release(std::move(p)); });
+        });
+
+        CHECK(lockedCreated.load() <= threads * (maxHeld + expansionSize));
+
+        const std::size_t operations = threads * std::size_t(operationsPerThread);
+        std::printf("%d threads, %zu acquire / release operations, %zu objects created (%zu with the mutex)\n",
+            threadCount, operations, created.load(), lockedCreated.load());
+        report("  ConcurrentObjectPool", concurrentMs, operations);
+        report("  ObjectPoolDynamic behind a mutex", lockedMs, operations);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int repeats = repeatFactor(argc, argv);
+    std::vector<int> threadCounts = { 1, 2, 4, 8 };
+
+    for (int n = 16; n <= std::min(32, int(std::thread::hardware_concurrency())); n *= 2)
+    {
+        threadCounts.push_back(n);
+    }
+
+    for (int threadCount : threadCounts)
+    {
+        run(threadCount, repeats);
+    }
+
+    return 0;
+}
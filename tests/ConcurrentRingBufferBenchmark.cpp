@@ -0,0 +1,250 @@
+// SPSCRingBuffer and MPMCRingBuffer against a mutex-guarded RingBuffer: every item arrives exactly once (in order from each
+// producer), and one-by-one / batched throughput plus ping-pong latency between two threads are timed
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentRingBuffer.h"
+#include "RingBuffer.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    constexpr std::size_t ringCapacity = 1024;
+    constexpr std::size_t batchSize = 32;
+
+    /// RingBuffer behind a mutex, with the try_ interface of the lock-free rings (RingBuffer itself overwrites when full)
+    template <typename T, std::size_t Capacity>
+    class LockedRingBuffer
+    {
+    public:
+        bool try_push(const T& val)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (ring.full())
+            {
+                return false;
+            }
+
+            ring.push_back(val);
+            return true;
+        }
+
+        std::size_t try_push_n(std::span<const T> vals)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            const std::size_t n = std::min(vals.size(), Capacity - ring.size());
+            ring.push_back_n(vals.first(n));
+            return n;
+        }
+
+        bool try_pop(T& out)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (ring.empty())
+            {
+                return false;
+            }
+
+            out = ring.front();
+            ring.pop_front();
+            return true;
+        }
+
+        std::size_t try_pop_n(std::span<T> out)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            return ring.pop_front_n(out);
+        }
+
+    private:
+        std::mutex mutex;
+        RingBuffer<T, Capacity> ring;
+    };
+
+    /// producers send item i as i * producerCount + producer + 1, so the receiver can tell where it came from and which one it was
+    template <typename Ring>
+    void produce(Ring& ring, std::uint64_t producer, std::uint64_t producerCount, std::uint64_t items, bool batched)
+    {
+        std::uint64_t batch[batchSize];
+        std::uint64_t i = 0;
+
+        while (i < items)
+        {
+            std::size_t pushed = 0;
+
+            if (batched)
+            {
+                const std::size_t n = std::size_t(std::min<std::uint64_t>(batchSize, items - i));
+                for (std::size_t k = 0; k < n; ++k) batch[k] = (i + k) * producerCount + producer + 1;
+                pushed = ring.try_push_n(std::span<const std::uint64_t>(batch, n));
+            }
+            else
+            {
+                pushed = ring.try_push(i * producerCount + producer + 1) ? 1 : 0;
+            }
+
+            i += pushed;
+
+            // a full ring means the consumers need the core
+            if (pushed == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    /// receives until received reaches total, marking each item in seen and checking it follows the last one from its producer
+    template <typename Ring>
+    void consume(Ring& ring, std::uint64_t producerCount, std::uint64_t total, std::atomic<std::uint64_t>& received,
+        std::vector<std::atomic<std::uint8_t>>& seen, bool batched)
+    {
+        std::uint64_t batch[batchSize];
+        std::vector<std::uint64_t> last(producerCount, 0);
+
+        while (received.load(std::memory_order_relaxed) < total)
+        {
+            std::size_t popped = 0;
+
+            if (batched)
+            {
+                popped = ring.try_pop_n(std::span<std::uint64_t>(batch, batchSize));
+            }
+            else
+            {
+                popped = ring.try_pop(batch[0]) ? 1 : 0;
+            }
+
+            for (std::size_t k = 0; k < popped; ++k)
+            {
+                const std::uint64_t value = batch[k];
+                CHECK(value > 0 && value <= total);
+                CHECK(seen[value - 1].fetch_add(1, std::memory_order_relaxed) == 0);
+
+                const std::uint64_t producer = (value - 1) % producerCount;
+                CHECK(value > last[producer]);
+                last[producer] = value;
+            }
+
+            if (popped == 0)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                received.fetch_add(popped, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// producerCount producers and consumerCount consumers move itemsPerProducer items each through a fresh ring
+    template <typename Ring>
+    double transfer(int repeats, int producerCount, int consumerCount, std::uint64_t itemsPerProducer, bool batched)
+    {
+        const std::uint64_t total = itemsPerProducer * std::uint64_t(producerCount);
+
+        return bestTimeMs(repeats, [&]
+        {
+            auto ring = std::make_unique<Ring>();
+            std::vector<std::atomic<std::uint8_t>> seen(total);
+            std::atomic<std::uint64_t> received{0};
+            std::vector<std::thread> threads;
+
+            for (int p = 0; p < producerCount; ++p)
+            {
+                threads.emplace_back([&, p] { produce(*ring, std::uint64_t(p), std::uint64_t(producerCount), itemsPerProducer, batched); });
+            }
+
+            for (int c = 0; c < consumerCount; ++c)
+            {
+                threads.emplace_back([&] { consume(*ring, std::uint64_t(producerCount), total, received, seen, batched); });
+            }
+
+            for (std::thread& t : threads)
+            {
+                t.join();
+            }
+
+            CHECK(received.load() == total);
+            CHECK(std::all_of(seen.begin(), seen.end(), [](const std::atomic<std::uint8_t>& s) { return s.load() == 1; }));
+        });
+    }
+
+    /// one item bounces between two threads through a ring each way; returns the best time for all rounds
+    template <typename Ring>
+    double pingPong(int repeats, std::uint64_t rounds)
+    {
+        return bestTimeMs(repeats, [&]
+        {
+            auto ping = std::make_unique<Ring>();
+            auto pong = std::make_unique<Ring>();
+
+            std::thread echo([&]
+            {
+                std::uint64_t value = 0;
+
+                for (std::uint64_t i = 0; i < rounds; ++i)
+                {
+                    while (!ping->try_pop(value)) std::this_thread::yield();
+                    while (!pong->try_push(value + 1)) std::this_thread::yield();
+                }
+            });
+
+            std::uint64_t value = 0;
+
+            for (std::uint64_t i = 0; i < rounds; ++i)
+            {
+                while (!ping->try_push(value)) std::this_thread::yield();
+                while (!pong->try_pop(value)) std::this_thread::yield();
+            }
+
+            echo.join();
+            CHECK(value == rounds);
+        });
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int repeats = 3 * repeatFactor(argc, argv);
+
+    using SPSC = SPSCRingBuffer<std::uint64_t, ringCapacity>;
+    using MPMC = MPMCRingBuffer<std::uint64_t, ringCapacity>;
+    using Locked = LockedRingBuffer<std::uint64_t, ringCapacity>;
+
+    constexpr std::uint64_t items = 200000;
+    std::printf("one producer, one consumer, %llu items\n", static_cast<unsigned long long>(items));
+    report("  SPSCRingBuffer, try_push / try_pop", transfer<SPSC>(repeats, 1, 1, items, false), items);
+    report("  MPMCRingBuffer, try_push / try_pop", transfer<MPMC>(repeats, 1, 1, items, false), items);
+    report("  RingBuffer + mutex, try_push / try_pop", transfer<Locked>(repeats, 1, 1, items, false), items);
+    report("  SPSCRingBuffer, batches of 32", transfer<SPSC>(repeats, 1, 1, items, true), items);
+    report("  MPMCRingBuffer, batches of 32", transfer<MPMC>(repeats, 1, 1, items, true), items);
+    report("  RingBuffer + mutex, batches of 32", transfer<Locked>(repeats, 1, 1, items, true), items);
+
+    for (int threads : { 2, 4 })
+    {
+        const std::uint64_t perProducer = items / std::uint64_t(threads);
+        std::printf("%d producers, %d consumers, %llu items\n", threads, threads, static_cast<unsigned long long>(items));
+        report("  MPMCRingBuffer, try_push / try_pop", transfer<MPMC>(repeats, threads, threads, perProducer, false), items);
+        report("  RingBuffer + mutex, try_push / try_pop", transfer<Locked>(repeats, threads, threads, perProducer, false), items);
+        report("  MPMCRingBuffer, batches of 32", transfer<MPMC>(repeats, threads, threads, perProducer, true), items);
+        report("  RingBuffer + mutex, batches of 32", transfer<Locked>(repeats, threads, threads, perProducer, true), items);
+    }
+
+    constexpr std::uint64_t rounds = 20000;
+    std::printf("ping-pong between two threads, %llu round trips\n", static_cast<unsigned long long>(rounds));
+    report("  SPSCRingBuffer", pingPong<SPSC>(repeats, rounds), rounds);
+    report("  MPMCRingBuffer", pingPong<MPMC>(repeats, rounds), rounds);
+    report("  RingBuffer + mutex", pingPong<Locked>(repeats, rounds), rounds);
+
+    return 0;
+}
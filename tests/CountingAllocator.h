@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global operator new / delete to count heap allocations.
+// Replacement allocation functions can't be inline, so include this in exactly one translation unit of a test
+
+namespace GameFoundationTests
+{
+    inline std::atomic<std::size_t> allocationCount{0};
+
+    /// heap allocations made through operator new since the program started
+    inline std::size_t allocations()
+    {
+        return allocationCount.load(std::memory_order_relaxed);
+    }
+
+    inline void* countedAllocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t))
+    {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        void* p = nullptr;
+
+        if (alignment > alignof(std::max_align_t))
+        {
+            // aligned_alloc wants the size to be a multiple of the alignment
+            p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        }
+        else
+        {
+            p = std::malloc(size ? size : 1);
+        }
+
+        if (!p)
+        {
+            throw std::bad_alloc();
+        }
+
+        return p;
+    }
+}
+
+void* operator new(std::size_t size) { return GameFoundationTests::countedAllocate(size); }
+void* operator new[](std::size_t size) { return GameFoundationTests::countedAllocate(size); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return GameFoundationTests::countedAllocate(size, std::size_t(alignment)); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return GameFoundationTests::countedAllocate(size, std::size_t(alignment)); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
@@ -0,0 +1,144 @@
+// DStarLite against a fresh AStar() search: after cells are blocked or opened and the changed edges notified, the repaired plan
+// costs the same as searching from scratch, and it is a legal walk from the (moving) start to the goal
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "AStar.h"
+#include "DStarLite.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    /// every step is a legal grid move and the steps add up to cost
+    void checkWalk(const GridGraph& grid, std::span<const GridGraph::NodeHandle> path, GridGraph::NodeHandle start, GridGraph::NodeHandle goal, double cost)
+    {
+        CHECK(!path.empty() && path.front() == start && path.back() == goal);
+
+        for (std::size_t i = 1; i < path.size(); ++i)
+        {
+            const int x = grid.x_of(path[i - 1]);
+            const int y = grid.y_of(path[i - 1]);
+            const int dx = grid.x_of(path[i]) - x;
+            const int dy = grid.y_of(path[i]) - y;
+            CHECK(std::abs(dx) <= 1 && std::abs(dy) <= 1 && (dx || dy) && grid.can_step(x, y, dx, dy));
+        }
+
+        CHECK(std::abs(pathCost(grid, path, GridOctileDistance{}) - cost) < 1e-6);
+    }
+
+    /// toggling a cell changes its own edges and the diagonals that cut its corners, so every node around it is notified
+    template <typename Planner>
+    void notifyAround(Planner& planner, const GridGraph& grid, int cx, int cy)
+    {
+        for (int y = cy - 1; y <= cy + 1; ++y)
+        {
+            for (int x = cx - 1; x <= cx + 1; ++x)
+            {
+                if (grid.in_bounds(x, y))
+                {
+                    planner.notifyEdgeChanged(grid.handle_of(cx, cy), grid.handle_of(x, y));
+                }
+            }
+        }
+    }
+}
+
+int main()
+{
+    const GridOctileDistance octile;
+    int rounds = 0;
+    int unreachable = 0;
+
+    for (unsigned seed = 1; seed <= 6; ++seed)
+    {
+        GridGraph grid = randomGrid(40, 40, 22, seed);
+        std::mt19937 rng(seed);
+
+        GridGraph::NodeHandle start = grid.handle_of(1, 1);
+        const GridGraph::NodeHandle goal = grid.handle_of(38, 37);
+        grid.set_walkable(1, 1, true);
+        grid.set_walkable(38, 37, true);
+
+        DStarLite planner(grid, octile, octile);
+        AStarContext<GridGraph> context;
+        planner.begin(start, goal);
+
+        for (int step = 0; step < 50; ++step)
+        {
+            const std::span<const GridGraph::NodeHandle> repaired = planner.plan();
+            const std::vector<GridGraph::NodeHandle> plan(repaired.begin(), repaired.end());
+            const std::span<const GridGraph::NodeHandle> reference = AStar(context, grid, start, goal, octile, octile);
+
+            CHECK(plan.empty() == reference.empty());
+            ++rounds;
+
+            if (reference.empty())
+            {
+                ++unreachable;
+                CHECK(std::isinf(planner.pathCost()));
+            }
+            else
+            {
+                const double referenceCost = pathCost(grid, reference, octile);
+                CHECK(std::abs(planner.pathCost() - referenceCost) < 1e-6);
+                checkWalk(grid, plan, start, goal, referenceCost);
+
+                // the agent walks one step along the plan now and then
+                if (step % 4 == 3 && plan.size() > 2)
+                {
+                    start = plan[1];
+                    planner.moveStart(start);
+                }
+            }
+
+            // block or open a few cells, never the agent's or the goal's
+            for (int change = 0; change < 3; ++change)
+            {
+                const int x = int(rng() % grid.width());
+                const int y = int(rng() % grid.height());
+                const GridGraph::NodeHandle cell = grid.handle_of(x, y);
+
+                if (cell != start && cell != goal)
+                {
+                    grid.set_walkable(x, y, !grid.is_walkable(x, y));
+                    notifyAround(planner, grid, x, y);
+                }
+            }
+        }
+    }
+
+    // a goal walled in completely, then opened again
+    GridGraph grid(12, 12);
+    DStarLite planner(grid, octile, octile);
+    planner.begin(grid.handle_of(0, 0), grid.handle_of(10, 10));
+    CHECK(!planner.plan().empty());
+
+    for (int x = 9; x <= 11; ++x)
+    {
+        for (int y = 9; y <= 11; ++y)
+        {
+            if (x != 10 || y != 10)
+            {
+                grid.set_walkable(x, y, false);
+                notifyAround(planner, grid, x, y);
+            }
+        }
+    }
+
+    CHECK(planner.plan().empty() && std::isinf(planner.pathCost()));
+
+    // a diagonal opening would need both corners open as well; a straight one doesn't
+    grid.set_walkable(10, 9, true);
+    notifyAround(planner, grid, 10, 9);
+    CHECK(!planner.plan().empty());
+
+    AStarContext<GridGraph> context;
+    const auto reference = AStar(context, grid, grid.handle_of(0, 0), grid.handle_of(10, 10), octile, octile);
+    CHECK(std::abs(planner.pathCost() - pathCost(grid, reference, octile)) < 1e-9);
+
+    std::printf("ok: %d replans checked against AStar(), %d with the goal cut off\n", rounds, unreachable);
+    return 0;
+}
@@ -0,0 +1,164 @@
+// HierarchicalPathfinder on grids: findPath() + refineAll() give a legal walk from start to target exactly when AStar() finds one,
+// never cheaper than the optimum, and the paths stay legal after notifyEdgeChanged() rebuilds the clusters around changed cells
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "AStar.h"
+#include "HierarchicalPathfinder.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    constexpr int clusterSize = 8;
+
+    /// square blocks of clusterSize x clusterSize cells
+    struct GridClusters
+    {
+        std::uint32_t operator()(const GridGraph& grid, GridGraph::NodeHandle node) const
+        {
+            const std::uint32_t columns = (grid.width() + clusterSize - 1) / clusterSize;
+            return std::uint32_t(grid.y_of(node) / clusterSize) * columns + std::uint32_t(grid.x_of(node) / clusterSize);
+        }
+    };
+
+    /// every step is a legal grid move from start to target; returns what the steps cost
+    double checkWalk(const GridGraph& grid, const std::vector<GridGraph::NodeHandle>& path, GridGraph::NodeHandle start, GridGraph::NodeHandle target)
+    {
+        CHECK(!path.empty() && path.front() == start && path.back() == target);
+
+        for (std::size_t i = 1; i < path.size(); ++i)
+        {
+            const int x = grid.x_of(path[i - 1]);
+            const int y = grid.y_of(path[i - 1]);
+            const int dx = grid.x_of(path[i]) - x;
+            const int dy = grid.y_of(path[i]) - y;
+            CHECK(std::abs(dx) <= 1 && std::abs(dy) <= 1 && (dx || dy) && grid.can_step(x, y, dx, dy));
+        }
+
+        return pathCost(grid, std::span<const GridGraph::NodeHandle>(path), GridOctileDistance{});
+    }
+
+    template <typename Pathfinder>
+    void checkQueries(Pathfinder& pathfinder, const GridGraph& grid, std::mt19937& rng, int queries, int& found)
+    {
+        const GridOctileDistance octile;
+        AStarContext<GridGraph> context;
+        typename Pathfinder::Path path;
+        std::vector<GridGraph::NodeHandle> refined;
+
+        for (int q = 0; q < queries; ++q)
+        {
+            const GridGraph::NodeHandle start = GridGraph::NodeHandle(rng() % grid.size());
+            const GridGraph::NodeHandle target = GridGraph::NodeHandle(rng() % grid.size());
+
+            if (!grid[start] || !grid[target])
+            {
+                continue;
+            }
+
+            const auto reference = AStar(context, grid, start, target, octile, octile);
+            const bool ok = pathfinder.findPath(start, target, path);
+            CHECK(ok == !reference.empty());
+
+            if (!ok)
+            {
+                continue;
+            }
+
+            pathfinder.refineAll(path, refined);
+            const double cost = checkWalk(grid, refined, start, target);
+            const double optimal = pathCost(grid, reference, octile);
+
+            // the abstract cost is what the refined legs cost, and no route beats the optimum
+            CHECK(std::abs(cost - path.cost) < 1e-6);
+            CHECK(cost >= optimal - 1e-6);
+            ++found;
+        }
+    }
+}
+
+int main()
+{
+    int found = 0;
+
+    for (unsigned seed = 1; seed <= 4; ++seed)
+    {
+        GridGraph grid = randomGrid(48, 40, 20, seed);
+        std::vector<GridGraph::NodeHandle> nodes(grid.size());
+        std::iota(nodes.begin(), nodes.end(), 0u);
+
+        HierarchicalPathfinder pathfinder(grid, GridClusters{}, GridOctileDistance{}, GridOctileDistance{});
+        pathfinder.build(nodes);
+        CHECK(pathfinder.clusterCount() == 6 * 5 && pathfinder.abstractNodeCount() > 0);
+
+        std::mt19937 rng(seed);
+        checkQueries(pathfinder, grid, rng, 60, found);
+
+        // toggle cells, preferring ones on cluster borders where transitions sit, and notify every edge that could have changed
+        for (int round = 0; round < 15; ++round)
+        {
+            for (int change = 0; change < 4; ++change)
+            {
+                int x = int(rng() % grid.width());
+                const int y = int(rng() % grid.height());
+
+                if (change % 2 == 0)
+                {
+                    x = (x / clusterSize) * clusterSize + (rng() % 2 ? 0 : clusterSize - 1);
+                }
+
+                grid.set_walkable(x, y, !grid.is_walkable(x, y));
+
+                for (int ny = y - 1; ny <= y + 1; ++ny)
+                {
+                    for (int nx = x - 1; nx <= x + 1; ++nx)
+                    {
+                        if (grid.in_bounds(nx, ny) && (nx != x || ny != y))
+                        {
+                            pathfinder.notifyEdgeChanged(grid.handle_of(x, y), grid.handle_of(nx, ny));
+                        }
+                    }
+                }
+            }
+
+            checkQueries(pathfinder, grid, rng, 20, found);
+        }
+
+        // the incremental repair ends where a full rebuild does
+        HierarchicalPathfinder rebuilt(grid, GridClusters{}, GridOctileDistance{}, GridOctileDistance{});
+        rebuilt.build(nodes);
+        CHECK(rebuilt.abstractNodeCount() == pathfinder.abstractNodeCount());
+    }
+
+    // a wall across the whole map cuts every route; one gap in it restores them
+    GridGraph wall(32, 32);
+    for (int y = 0; y < 32; ++y) wall.set_walkable(15, y, false);
+
+    std::vector<GridGraph::NodeHandle> nodes(wall.size());
+    std::iota(nodes.begin(), nodes.end(), 0u);
+    HierarchicalPathfinder pathfinder(wall, GridClusters{}, GridOctileDistance{}, GridOctileDistance{});
+    pathfinder.build(nodes);
+
+    HierarchicalPath<GridGraph::NodeHandle> path;
+    const GridGraph::NodeHandle start = wall.handle_of(2, 3);
+    const GridGraph::NodeHandle target = wall.handle_of(29, 30);
+    CHECK(!pathfinder.findPath(start, target, path));
+
+    wall.set_walkable(15, 20, true);
+    pathfinder.notifyEdgeChanged(wall.handle_of(15, 20), wall.handle_of(14, 20));
+    pathfinder.notifyEdgeChanged(wall.handle_of(15, 20), wall.handle_of(16, 20));
+    CHECK(pathfinder.findPath(start, target, path));
+
+    std::vector<GridGraph::NodeHandle> refined;
+    pathfinder.refineAll(path, refined);
+    checkWalk(wall, refined, start, target);
+    CHECK(std::find(refined.begin(), refined.end(), wall.handle_of(15, 20)) != refined.end());
+
+    std::printf("ok: %d hierarchical paths checked\n", found);
+    return 0;
+}
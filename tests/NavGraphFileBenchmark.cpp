@@ -0,0 +1,168 @@
+// Memory-mapped navgraph files: a written graph maps back unchanged, damaged files are rejected, and mapping is timed against
+// rebuilding the CSR graph from its source
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "AStar.h"
+#include "NavGraphFile.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    std::vector<char> readFile(const std::string& path)
+    {
+        std::ifstream in(path, std::ios::binary);
+        return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    void writeFile(const std::string& path, const std::vector<char>& bytes)
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), std::streamsize(bytes.size()));
+    }
+
+    /// writes a damaged copy of original to path and returns what open() makes of it
+    template <typename Damage>
+    NavGraphFileStatus openDamaged(const std::string& path, std::vector<char> bytes, Damage damage, bool verifyChecksum, bool verifyStructure = true)
+    {
+        damage(bytes);
+        writeFile(path, bytes);
+        MappedNavGraph<std::uint8_t> mapped;
+        const NavGraphFileStatus status = mapped.open(path.c_str(), verifyChecksum, verifyStructure);
+        CHECK(mapped.is_open() == (status == NavGraphFileStatus::Ok));
+        return status;
+    }
+
+    template <typename T>
+    void poke(std::vector<char>& bytes, std::uint64_t offset, T value)
+    {
+        std::memcpy(bytes.data() + offset, &value, sizeof(T));
+    }
+
+    NavGraphFileHeader headerOf(const std::vector<char>& bytes)
+    {
+        NavGraphFileHeader header;
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        return header;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int repeats = repeatFactor(argc, argv);
+    const GridGraph grid = randomGrid(256, 256, 25, 5);
+    const GridOctileDistance octile;
+
+    std::vector<GridGraph::NodeHandle> handles(grid.size());
+    std::iota(handles.begin(), handles.end(), 0u);
+    const auto identity = [](GridGraph::NodeHandle h) { return h; };
+
+    const auto csr = CSRGraph<std::uint8_t>::fromGraph(grid, std::span<const GridGraph::NodeHandle>(handles), identity, octile);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "GameFoundationNavGraphBenchmark.nav").string();
+    const std::string damagedPath = path + ".damaged";
+    CHECK(writeNavGraph(path.c_str(), csr) == NavGraphFileStatus::Ok);
+
+    // round trip: same arrays, same search results
+    MappedNavGraph<std::uint8_t> mapped;
+    CHECK(mapped.open(path.c_str()) == NavGraphFileStatus::Ok);
+    CHECK(mapped.is_open());
+
+    const auto& view = mapped.graph();
+    CHECK(view.size() == csr.size() && view.edge_count() == csr.edge_count() && view.has_edge_costs());
+
+    for (std::uint32_t n = 0; n < csr.size(); ++n)
+    {
+        const auto a = csr.neighbors_of(n);
+        const auto b = view.neighbors_of(n);
+        CHECK(view[n] == csr[n]);
+        CHECK(a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin()));
+    }
+
+    auto heuristic = [&](const auto&, std::uint32_t a, std::uint32_t b) { return octile(grid, a, b); };
+    AStarContext<CSRGraph<std::uint8_t>> csrContext;
+    AStarContext<CSRGraphView<std::uint8_t>> viewContext;
+    std::mt19937 rng(5);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        const std::uint32_t start = std::uint32_t(rng() % csr.size());
+        const std::uint32_t target = std::uint32_t(rng() % csr.size());
+        const auto a = AStar(csrContext, csr, start, target, CSREdgeCostFunction{}, heuristic);
+        const auto b = AStar(viewContext, view, start, target, CSREdgeCostFunction{}, heuristic);
+        CHECK(a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin()));
+    }
+
+    // damaged or mismatched files never map
+    const std::vector<char> original = readFile(path);
+    const NavGraphFileHeader header = headerOf(original);
+    const auto untouched = [](std::vector<char>&) {};
+
+    CHECK(openDamaged(damagedPath, original, untouched, true) == NavGraphFileStatus::Ok);
+    CHECK(openDamaged(damagedPath, original, [&](std::vector<char>& b) { b[header.neighborsOffset + 5] ^= 1; }, true) == NavGraphFileStatus::ChecksumMismatch);
+    CHECK(openDamaged(damagedPath, original, [](std::vector<char>& b) { b[0] = 'X'; }, false) == NavGraphFileStatus::BadMagic);
+    CHECK(openDamaged(damagedPath, original, [](std::vector<char>& b) { b.resize(b.size() / 2); }, false) == NavGraphFileStatus::Truncated);
+
+    // without the checksum, the structural checks still catch bad counts, offsets and neighbor indices
+    CHECK(openDamaged(damagedPath, original, [&](std::vector<char>& b) { poke(b, offsetof(NavGraphFileHeader, nodeCount), ~std::uint64_t(0) / 4 + 1); }, false)
+        == NavGraphFileStatus::Corrupt);
+    CHECK(openDamaged(damagedPath, original, [&](std::vector<char>& b) { poke(b, offsetof(NavGraphFileHeader, edgeCount), std::uint64_t(1) << 62); }, false)
+        == NavGraphFileStatus::Corrupt);
+    CHECK(openDamaged(damagedPath, original, [&](std::vector<char>& b) { poke(b, header.offsetsOffset, std::uint32_t(1)); }, false)
+        == NavGraphFileStatus::Corrupt);
+    CHECK(openDamaged(damagedPath, original, [&](std::vector<char>& b) { poke(b, header.offsetsOffset + 4 * 10, ~std::uint32_t(0)); }, false)
+        == NavGraphFileStatus::Corrupt);
+    CHECK(openDamaged(damagedPath, original, [&](std::vector<char>& b) { poke(b, header.neighborsOffset + 4, std::uint32_t(csr.size())); }, false)
+        == NavGraphFileStatus::Corrupt);
+
+    MappedNavGraph<std::uint16_t> wrongNodeType;
+    CHECK(wrongNodeType.open(path.c_str()) == NavGraphFileStatus::LayoutMismatch);
+
+    MappedNavGraph<std::uint8_t> missing;
+    CHECK(missing.open((path + ".missing").c_str()) == NavGraphFileStatus::OpenFailed && !missing.is_open());
+
+    // map time against rebuilding the graph from its source
+    std::size_t sink = 0;
+
+    const double rebuildMs = bestTimeMs(3 * repeats, [&]
+    {
+        sink += CSRGraph<std::uint8_t>::fromGraph(grid, std::span<const GridGraph::NodeHandle>(handles), identity, octile).edge_count();
+    });
+
+    const auto timeOpen = [&](bool verifyChecksum, bool verifyStructure)
+    {
+        return bestTimeMs(3 * repeats, [&]
+        {
+            MappedNavGraph<std::uint8_t> file;
+            CHECK(file.open(path.c_str(), verifyChecksum, verifyStructure) == NavGraphFileStatus::Ok);
+            sink += file.graph().edge_count();
+        });
+    };
+
+    const double verifiedMs = timeOpen(true, true);
+    const double structureMs = timeOpen(false, true);
+    const double unverifiedMs = timeOpen(false, false);
+
+    std::printf("256x256 grid, %zu nodes, %zu edges, %zu byte file\n", csr.size(), csr.edge_count(), original.size());
+    report("rebuild CSRGraph from the GridGraph", rebuildMs, 1);
+    report("open, checksum and structure checks", verifiedMs, 1);
+    report("open, structure checks only", structureMs, 1);
+    report("open, no verification", unverifiedMs, 1);
+    CHECK(sink > 0);
+
+    mapped.close();
+    std::filesystem::remove(path);
+    std::filesystem::remove(damagedPath);
+    return 0;
+}
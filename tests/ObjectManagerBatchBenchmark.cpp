@@ -0,0 +1,276 @@
+// Batched ObjectManager operations: insertObjects / removeObjects / lookupObjects / compact agree with the one-at-a-time calls,
+// handles from before a compact never resolve to other objects, and the batched calls are timed against plain loops
+#include <algorithm>
+#include <deque>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ObjectManager.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    /// random batches of inserts and removes with a compact every few rounds, checked against a list of what should be live
+    void randomizedBatches()
+    {
+        std::mt19937 rng(2);
+
+        for (int round = 0; round < 20; ++round)
+        {
+            ObjectManager<std::string> manager;
+            std::vector<ObjectHandle> live;
+            std::vector<std::string> liveValues;
+
+            for (int step = 0; step < 40; ++step)
+            {
+                std::vector<std::string> values(rng() % 50);
+                for (std::string& v : values) v = std::to_string(rng());
+
+                std::vector<std::string> moved = values;
+                std::vector<ObjectHandle> handles(values.size(), ObjectHandle(0u));
+                CHECK(manager.insertObjects(moved, std::span(handles)) == values.size());
+
+                for (std::size_t i = 0; i < handles.size(); ++i)
+                {
+                    CHECK(*manager.lookupObject(handles[i]) == values[i]);
+                    live.push_back(handles[i]);
+                    liveValues.push_back(values[i]);
+                }
+
+                // remove a random prefix of a shuffled live list; a second remove of the same handles finds nothing
+                std::vector<std::size_t> order(live.size());
+                std::iota(order.begin(), order.end(), std::size_t(0));
+                std::shuffle(order.begin(), order.end(), rng);
+
+                const std::size_t removeCount = rng() % (live.size() + 1);
+                std::vector<ObjectHandle> doomed;
+                std::vector<ObjectHandle> keptHandles;
+                std::vector<std::string> keptValues;
+
+                for (std::size_t k = 0; k < order.size(); ++k)
+                {
+                    if (k < removeCount)
+                    {
+                        doomed.push_back(live[order[k]]);
+                    }
+                    else
+                    {
+                        keptHandles.push_back(live[order[k]]);
+                        keptValues.push_back(liveValues[order[k]]);
+                    }
+                }
+
+                CHECK(manager.removeObjects(doomed) == doomed.size());
+                CHECK(manager.removeObjects(doomed) == 0);
+                live = std::move(keptHandles);
+                liveValues = std::move(keptValues);
+
+                if (step % 5 == 4)
+                {
+                    const std::vector<ObjectHandle> remap = manager.compact();
+
+                    for (ObjectHandle& h : live)
+                    {
+                        h = remap[h.index];
+                        CHECK(h.index < live.size());
+                    }
+
+                    // everything removed earlier stays dead, whether its slot was refilled, released or reappended later
+                    for (const ObjectHandle& h : doomed)
+                    {
+                        CHECK(manager.lookupObject(h) == nullptr);
+                    }
+                }
+
+                std::vector<std::string*> found(live.size());
+                manager.lookupObjects(live, found);
+
+                for (std::size_t i = 0; i < live.size(); ++i)
+                {
+                    CHECK(found[i] && *found[i] == liveValues[i]);
+                }
+
+                std::size_t iterated = 0;
+                for (const std::string& s : manager) iterated += s.empty() ? 0 : 1;
+                CHECK(iterated == live.size() && manager.size() == live.size());
+            }
+        }
+    }
+
+    /// a slot released by compact() and appended again must not bring an old handle back to life
+    void compactKeepsVersions()
+    {
+        ObjectManager<int, std::deque, ObjectHandle, true> manager;
+        const ObjectHandle first = manager.insertObject(1);
+        ObjectHandle second = manager.insertObject(2);
+
+        // push the second slot's version up, then release it from the tail
+        for (int i = 0; i < 4; ++i)
+        {
+            CHECK(manager.removeObject(second));
+            second = manager.insertObject(2);
+        }
+
+        CHECK(manager.removeObject(second));
+        manager.compact();
+
+        const ObjectHandle reused = manager.insertObject(3);
+        CHECK(reused.index == second.index && reused.version != second.version);
+        CHECK(manager.lookupObject(second) == nullptr);
+        CHECK(*manager.lookupObject(reused) == 3);
+        CHECK(*manager.lookupObject(first) == 1);
+
+        // the peak stays a peak after compact() shrinks the storage
+        CHECK(manager.removeObject(reused) && manager.removeObject(first));
+        manager.compact();
+        CHECK(manager.size() == 0 && manager.handleStats().peakSlots == 2);
+        manager.insertObject(4);
+        CHECK(manager.handleStats().peakSlots == 2);
+
+        // a retired slot at the end is kept: its last version can't be handed out again
+        ObjectManager<int> retiring;
+        ObjectHandle h = retiring.insertObject(0);
+
+        while (h.version != ObjectHandle::maxVersion)
+        {
+            CHECK(retiring.removeObject(h));
+            h = retiring.insertObject(0);
+        }
+
+        CHECK(retiring.removeObject(h));
+        retiring.compact();
+        CHECK(retiring.retiredSlots() == 1);
+        const ObjectHandle next = retiring.insertObject(7);
+        CHECK(next.index != h.index && retiring.lookupObject(h) == nullptr);
+    }
+
+    /// repeated, stale and retiring handles in one removeObjects batch count like the same removeObject calls
+    void removeBatchEdges()
+    {
+        ObjectManager<int, std::deque, ObjectHandle, true> manager;
+        const ObjectHandle a = manager.insertObject(1);
+        const ObjectHandle b = manager.insertObject(2);
+        ObjectHandle last = manager.insertObject(3);
+
+        while (last.version != ObjectHandle::maxVersion)
+        {
+            CHECK(manager.removeObject(last));
+            last = manager.insertObject(3);
+        }
+
+        const ObjectHandle batch[] = { a, a, last, ObjectHandle(b.index, b.version + 1), ObjectHandle(100u, 1u) };
+        CHECK(manager.removeObjects(batch) == 2);
+        CHECK(manager.size() == 1 && manager.retiredSlots() == 1 && *manager.lookupObject(b) == 2);
+        CHECK(manager.handleStats().staleRemoves == 2);
+
+        // the freed slot comes back, the retired one doesn't
+        const ObjectHandle reused = manager.insertObject(4);
+        CHECK(reused.index == a.index && reused.version != a.version);
+        CHECK(manager.insertObject(5).index == 3);
+    }
+
+    /// a cache line per object, so a scattered walk over a few hundred thousand of them misses the cache
+    struct Body
+    {
+        int id;
+        float state[15];
+    };
+
+    void benchmark(int repeats)
+    {
+        constexpr int count = 200000;
+        std::vector<Body> values(count);
+        for (int i = 0; i < count; ++i) values[i].id = i;
+
+        ObjectManager<Body> manager;
+        std::vector<ObjectHandle> handles(count, ObjectHandle(0u));
+        std::vector<Body*> found(count);
+        std::size_t sink = 0;
+
+        const double loopInsertMs = bestTimeMs(3 * repeats, [&]
+        {
+            manager.clear();
+            for (int i = 0; i < count; ++i) handles[i] = manager.insertObject(Body(values[i]));
+        });
+
+        const double batchInsertMs = bestTimeMs(3 * repeats, [&]
+        {
+            manager.clear();
+            std::vector<Body> batch = values;
+            sink += manager.insertObjects(batch, std::span(handles));
+        });
+
+        // scattered lookups that read the object
+        std::vector<ObjectHandle> scattered = handles;
+        std::shuffle(scattered.begin(), scattered.end(), std::mt19937(7));
+
+        const double loopLookupMs = bestTimeMs(3 * repeats, [&]
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                found[i] = manager.lookupObject(scattered[i]);
+                sink += std::size_t(found[i]->id);
+            }
+        });
+
+        const double batchLookupMs = bestTimeMs(3 * repeats, [&]
+        {
+            manager.lookupObjects(scattered, found);
+            for (const Body* b : found) sink += std::size_t(b->id);
+        });
+
+        for (int i = 0; i < count; ++i)
+        {
+            CHECK(found[i] && found[i]->id == int(scattered[i].index));
+        }
+
+        // refilling the manager isn't part of the time
+        const auto timeRemove = [&](auto&& remove)
+        {
+            double best = 0.0;
+
+            for (int r = 0; r < 3 * repeats; ++r)
+            {
+                manager.clear();
+                std::vector<Body> batch = values;
+                manager.insertObjects(batch, std::span(handles));
+
+                const double ms = bestTimeMs(1, remove);
+                CHECK(manager.size() == 0);
+                best = (r == 0 || ms < best) ? ms : best;
+            }
+
+            return best;
+        };
+
+        const double loopRemoveMs = timeRemove([&]
+        {
+            for (const ObjectHandle& h : scattered) sink += manager.removeObject(h) ? 1 : 0;
+        });
+
+        const double batchRemoveMs = timeRemove([&] { sink += manager.removeObjects(scattered); });
+
+        CHECK(sink > 0 && manager.size() == 0);
+
+        std::printf("%d objects of %zu bytes\n", count, sizeof(Body));
+        report("insertObject loop", loopInsertMs, count);
+        report("insertObjects", batchInsertMs, count);
+        report("lookupObject loop, shuffled handles", loopLookupMs, count);
+        report("lookupObjects, shuffled handles", batchLookupMs, count);
+        report("removeObject loop, shuffled handles", loopRemoveMs, count);
+        report("removeObjects, shuffled handles", batchRemoveMs, count);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    randomizedBatches();
+    compactKeepsVersions();
+    removeBatchEdges();
+    benchmark(repeatFactor(argc, argv));
+    return 0;
+}
@@ -0,0 +1,130 @@
+// PackedObjectManager against ObjectManager at 10%, 50% and 90% occupancy: same live objects and lookups, iteration and lookup times
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "ObjectManager.h"
+#include "PackedObjectManager.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    struct Particle
+    {
+        float position[3];
+        float velocity[3];
+    };
+
+    Particle makeParticle(int i)
+    {
+        const float f = float(i);
+        return { { f, f, f }, { 1.0f, 0.0f, -1.0f } };
+    }
+
+    template <typename Range>
+    double sumX(Range& range)
+    {
+        double total = 0.0;
+
+        for (const Particle& p : range)
+        {
+            total += p.position[0];
+        }
+
+        return total;
+    }
+
+    void run(int occupancyPercent, int repeats)
+    {
+        constexpr int slotCount = 100000;
+
+        ObjectManager<Particle> sparse;
+        PackedObjectManager<Particle> packed;
+        std::vector<ObjectHandle> sparseHandles;
+        std::vector<ObjectHandle> packedHandles;
+
+        for (int i = 0; i < slotCount; ++i)
+        {
+            sparseHandles.push_back(sparse.insertObject(makeParticle(i)));
+            packedHandles.push_back(packed.insertObject(makeParticle(i)));
+        }
+
+        // remove the same random subset from both, leaving occupancyPercent of the slots live
+        std::vector<int> order(slotCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), std::mt19937(occupancyPercent));
+
+        const int removeCount = slotCount - slotCount * occupancyPercent / 100;
+        std::vector<bool> live(slotCount, true);
+
+        for (int k = 0; k < removeCount; ++k)
+        {
+            const int i = order[k];
+            CHECK(sparse.removeObject(sparseHandles[i]));
+            CHECK(packed.removeObject(packedHandles[i]));
+            live[i] = false;
+        }
+
+        CHECK(sparse.size() == packed.size());
+        CHECK(packed.size() == std::size_t(slotCount - removeCount));
+
+        std::vector<ObjectHandle> liveSparse;
+        std::vector<ObjectHandle> livePacked;
+        double expected = 0.0;
+
+        for (int i = 0; i < slotCount; ++i)
+        {
+            Particle* a = sparse.lookupObject(sparseHandles[i]);
+            Particle* b = packed.lookupObject(packedHandles[i]);
+            CHECK((a != nullptr) == live[i] && (b != nullptr) == live[i]);
+
+            if (live[i])
+            {
+                CHECK(a->position[0] == float(i) && b->position[0] == float(i));
+                liveSparse.push_back(sparseHandles[i]);
+                livePacked.push_back(packedHandles[i]);
+                expected += float(i);
+            }
+        }
+
+        CHECK(sumX(sparse) == expected && sumX(packed) == expected);
+
+        double sink = 0.0;
+        const int iterations = 20 * repeats;
+        const double sparseIterateMs = bestTimeMs(iterations, [&] { sink += sumX(sparse); });
+        const double packedIterateMs = bestTimeMs(iterations, [&] { sink += sumX(packed); });
+
+        const double sparseLookupMs = bestTimeMs(iterations, [&]
+        {
+            for (const ObjectHandle& h : liveSparse) sink += sparse.lookupObject(h)->velocity[0];
+        });
+
+        const double packedLookupMs = bestTimeMs(iterations, [&]
+        {
+            for (const ObjectHandle& h : livePacked) sink += packed.lookupObject(h)->velocity[0];
+        });
+
+        CHECK(sink > 0.0);
+
+        std::printf("%d%% occupancy, %zu live of %d slots\n", occupancyPercent, packed.size(), slotCount);
+        report("  iterate, ObjectManager", sparseIterateMs, packed.size());
+        report("  iterate, PackedObjectManager", packedIterateMs, packed.size());
+        report("  lookup, ObjectManager", sparseLookupMs, packed.size());
+        report("  lookup, PackedObjectManager", packedLookupMs, packed.size());
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int repeats = repeatFactor(argc, argv);
+
+    for (int occupancy : { 10, 50, 90 })
+    {
+        run(occupancy, repeats);
+    }
+
+    return 0;
+}
@@ -0,0 +1,216 @@
+// RingBuffer bulk operations: push_back_n / pop_front_n / emplace_back match a std::deque model (overwriting when full, no
+// default constructor needed, every constructed element destroyed once), and blocks are timed against element-wise loops
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "RingBuffer.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    int liveObjects = 0;
+
+    /// no default constructor, and counts its instances so leaked or doubly destroyed slots show up
+    struct Tracked
+    {
+        int value;
+
+        explicit Tracked(int v) : value(v) { ++liveObjects; }
+        Tracked(const Tracked& other) : value(other.value) { ++liveObjects; }
+        Tracked(Tracked&& other) : value(other.value) { ++liveObjects; }
+        Tracked& operator=(const Tracked&) = default;
+        Tracked& operator=(Tracked&&) = default;
+        ~Tracked() { --liveObjects; }
+    };
+
+    template <typename T, std::size_t Capacity>
+    void checkAgainstModel()
+    {
+        {
+            RingBuffer<T, Capacity> ring;
+            std::deque<int> model;
+            std::mt19937 rng(static_cast<unsigned>(Capacity));
+            int next = 0;
+
+            const auto trimModel = [&] { while (model.size() > Capacity) model.pop_front(); };
+
+            for (int step = 0; step < 10000; ++step)
+            {
+                switch (rng() % 7)
+                {
+                case 0:
+                    ring.emplace_back(next);
+                    model.push_back(next++);
+                    trimModel();
+                    break;
+
+                case 1:
+                    // the argument refers to the element a full ring overwrites
+                    if (!model.empty())
+                    {
+                        ring.emplace_back(ring.front());
+                        model.push_back(model.front());
+                        trimModel();
+                    }
+                    break;
+
+                case 2:
+                    if (!model.empty())
+                    {
+                        ring.pop_front();
+                        model.pop_front();
+                    }
+                    break;
+
+                case 3:
+                {
+                    // blocks up to twice the capacity: only the newest Capacity values survive
+                    std::vector<T> block;
+                    const int n = int(rng() % (2 * Capacity + 2));
+
+                    for (int i = 0; i < n; ++i)
+                    {
+                        block.emplace_back(next);
+                        model.push_back(next++);
+                    }
+
+                    trimModel();
+                    ring.push_back_n(block);
+                    break;
+                }
+
+                case 4:
+                {
+                    std::vector<T> out(rng() % (Capacity + 2), T(-1));
+                    const std::size_t n = ring.pop_front_n(out);
+                    CHECK(n == std::min(out.size(), model.size()));
+
+                    for (std::size_t i = 0; i < n; ++i)
+                    {
+                        CHECK(out[i].value == model.front());
+                        model.pop_front();
+                    }
+                    break;
+                }
+
+                case 5:
+                    if (!model.empty())
+                    {
+                        ring.pop_back();
+                        model.pop_back();
+                    }
+                    break;
+
+                default:
+                    if (rng() % 40 == 0)
+                    {
+                        ring.clear();
+                        model.clear();
+                    }
+                    break;
+                }
+
+                CHECK(ring.size() == model.size());
+
+                for (std::size_t i = 0; i < model.size(); ++i)
+                {
+                    CHECK(ring[i].value == model[i]);
+                }
+            }
+        }
+
+        CHECK(liveObjects == 0);
+    }
+
+    struct Sample
+    {
+        int value;
+        Sample(int v = 0) : value(v) {}
+    };
+
+    /// moves input through the ring in blocks of block elements, in bulk or one at a time; each block popped is handed to sink
+    template <typename T, std::size_t Capacity, bool Bulk, typename Sink>
+    void stream(RingBuffer<T, Capacity>& ring, const std::vector<T>& input, std::vector<T>& output, std::size_t block, Sink&& sink)
+    {
+        for (std::size_t offset = 0; offset + block <= input.size(); offset += block)
+        {
+            if constexpr (Bulk)
+            {
+                ring.push_back_n(std::span<const T>(input.data() + offset, block));
+                CHECK(ring.pop_front_n(std::span<T>(output.data(), block)) == block);
+            }
+            else
+            {
+                for (std::size_t i = 0; i < block; ++i) ring.push_back(input[offset + i]);
+
+                for (std::size_t i = 0; i < block; ++i)
+                {
+                    output[i] = std::move(ring.front());
+                    ring.pop_front();
+                }
+            }
+
+            sink(output);
+        }
+    }
+
+    template <typename T>
+    void benchmarkType(const char* name, int repeats, T (*make)(int))
+    {
+        constexpr std::size_t Capacity = 4096;
+        constexpr std::size_t count = 1 << 20;
+
+        std::vector<T> input;
+        input.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) input.push_back(make(int(i)));
+
+        std::printf("%zu %s elements through RingBuffer<%s, %zu>\n", count, name, name, Capacity);
+
+        for (std::size_t block : { std::size_t(16), std::size_t(256), std::size_t(2048) })
+        {
+            std::vector<T> output(block);
+            RingBuffer<T, Capacity> ring;
+            // start part way round so blocks straddle the end of the storage
+            for (std::size_t i = 0; i < Capacity / 3; ++i) ring.push_back(make(0));
+            while (!ring.empty()) ring.pop_front();
+
+            // both ways hand back the input unchanged and in order
+            std::vector<T> bulkOut;
+            std::vector<T> loopOut;
+            stream<T, Capacity, true>(ring, input, output, block, [&](const std::vector<T>& b) { bulkOut.insert(bulkOut.end(), b.begin(), b.end()); });
+            stream<T, Capacity, false>(ring, input, output, block, [&](const std::vector<T>& b) { loopOut.insert(loopOut.end(), b.begin(), b.end()); });
+            CHECK(bulkOut == input && loopOut == input && ring.empty());
+
+            std::size_t sink = 0;
+            const auto touch = [&](const std::vector<T>& b) { sink += std::size_t(b[0]) + std::size_t(b[block - 1]); };
+            const double bulkMs = bestTimeMs(3 * repeats, [&] { stream<T, Capacity, true>(ring, input, output, block, touch); });
+            const double loopMs = bestTimeMs(3 * repeats, [&] { stream<T, Capacity, false>(ring, input, output, block, touch); });
+            CHECK(sink > 0);
+
+            char label[64];
+            std::snprintf(label, sizeof(label), "  blocks of %zu, push_back_n / pop_front_n", block);
+            report(label, bulkMs, count);
+            std::snprintf(label, sizeof(label), "  blocks of %zu, push_back / pop_front loop", block);
+            report(label, loopMs, count);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    checkAgainstModel<Tracked, 1>();
+    checkAgainstModel<Tracked, 5>();
+    checkAgainstModel<Tracked, 8>();
+    checkAgainstModel<Sample, 7>();
+    checkAgainstModel<Sample, 16>();
+
+    const int repeats = repeatFactor(argc, argv);
+    benchmarkType<float>("float", repeats, [](int i) { return float(i % 1000); });
+    benchmarkType<std::uint8_t>("uint8_t", repeats, [](int i) { return std::uint8_t(i); });
+    return 0;
+}
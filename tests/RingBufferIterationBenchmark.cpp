@@ -0,0 +1,158 @@
+// RingBuffer element access: operator[], iterators and segments() agree with a std::deque model for power-of-two and other
+// capacities, and summing a full, wrapped history is timed through each of them
+#include <cstring>
+#include <deque>
+#include <random>
+#include <vector>
+
+#include "RingBuffer.h"
+#include "RingBufferStatistics.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    /// random pushes, pops and clears, comparing every way of reading the ring with the model after each step
+    template <std::size_t Capacity>
+    void checkAgainstModel()
+    {
+        RingBuffer<int, Capacity> ring;
+        std::deque<int> model;
+        std::mt19937 rng(static_cast<unsigned>(Capacity));
+
+        for (int step = 0; step < 5000; ++step)
+        {
+            const unsigned op = rng() % 5;
+
+            if (op < 3)
+            {
+                ring.push_back(step);
+                model.push_back(step);
+                if (model.size() > Capacity) model.pop_front();
+            }
+            else if (op == 3 && !model.empty())
+            {
+                ring.pop_back();
+                model.pop_back();
+            }
+            else if (op == 4 && rng() % 50 == 0)
+            {
+                ring.clear();
+                model.clear();
+            }
+
+            CHECK(ring.size() == model.size());
+
+            for (std::size_t i = 0; i < model.size(); ++i)
+            {
+                CHECK(ring[i] == model[i]);
+            }
+
+            std::size_t i = 0;
+            for (int v : ring) CHECK(v == model[i++]);
+            CHECK(i == model.size());
+
+            const auto [first, second] = ring.segments();
+            CHECK(first.size() + second.size() == model.size());
+            CHECK(!first.empty() || second.empty());
+
+            i = 0;
+            for (int v : first) CHECK(v == model[i++]);
+            for (int v : second) CHECK(v == model[i++]);
+
+            if (!model.empty())
+            {
+                CHECK(ring.front() == model.front() && ring.back() == model.back());
+            }
+        }
+    }
+
+    template <std::size_t Capacity>
+    void benchmark(int repeats)
+    {
+        // full and wrapped part way round, as a long running history is
+        RingBuffer<float, Capacity> ring;
+        for (std::size_t i = 0; i < Capacity + Capacity / 3; ++i) ring.push_back(float(i % 97));
+
+        double expected = 0.0;
+        for (std::size_t i = Capacity / 3; i < Capacity + Capacity / 3; ++i) expected += float(i % 97);
+
+        const int passes = 2000;
+        const std::size_t operations = std::size_t(passes) * Capacity;
+        std::vector<float> copy(Capacity);
+        double total = 0.0;
+
+        const auto timePasses = [&](auto&& sum)
+        {
+            return bestTimeMs(3 * repeats, [&]
+            {
+                for (int p = 0; p < passes; ++p)
+                {
+                    const double s = sum();
+                    CHECK(s == expected);
+                    total += s;
+                }
+            });
+        };
+
+        const double indexMs = timePasses([&]
+        {
+            double s = 0.0;
+            for (std::size_t i = 0; i < ring.size(); ++i) s += ring[i];
+            return s;
+        });
+
+        const double iteratorMs = timePasses([&]
+        {
+            double s = 0.0;
+            for (float v : ring) s += v;
+            return s;
+        });
+
+        const double segmentsMs = timePasses([&]
+        {
+            double s = 0.0;
+            const auto [first, second] = ring.segments();
+            for (float v : first) s += v;
+            for (float v : second) s += v;
+            return s;
+        });
+
+        const double copyMs = timePasses([&]
+        {
+            const auto [first, second] = ring.segments();
+            std::memcpy(copy.data(), first.data(), first.size_bytes());
+            std::memcpy(copy.data() + first.size(), second.data(), second.size_bytes());
+
+            double s = 0.0;
+            for (float v : copy) s += v;
+            return s;
+        });
+
+        const double reduceMs = timePasses([&] { return double(RingBufferReduce::sum(ring)); });
+
+        CHECK(total > 0.0);
+
+        std::printf("sum of a full RingBuffer<float, %zu>, %d passes\n", Capacity, passes);
+        report("  operator[]", indexMs, operations);
+        report("  iterator", iteratorMs, operations);
+        report("  segments(), scalar loop", segmentsMs, operations);
+        report("  segments(), memcpy out then scalar loop", copyMs, operations);
+        report("  segments(), RingBufferReduce::sum", reduceMs, operations);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    checkAgainstModel<1>();
+    checkAgainstModel<7>();
+    checkAgainstModel<8>();
+    checkAgainstModel<100>();
+    checkAgainstModel<128>();
+
+    const int repeats = repeatFactor(argc, argv);
+    benchmark<1000>(repeats);
+    benchmark<1024>(repeats);
+    return 0;
+}
@@ -0,0 +1,224 @@
+// SlabObjectPool against the moving pools (ObjectPool, ObjectPoolDynamic): objects stay put and intact under churn, a throwing
+// constructor leaves the pool usable, and acquire / release are timed for a large object
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ObjectPool.h"
+#include "ObjectPoolDynamic.h"
+#include "SlabObjectPool.h"
+#include "TestCommon.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    /// big enough that moving it in and out of a pool shows up
+    struct alignas(32) Actor
+    {
+        std::string name;
+        float transform[16] = {};
+        float state[40] = {};
+
+        Actor() = default;
+        explicit Actor(int id) : name("actor " + std::to_string(id)) { transform[0] = float(id); }
+    };
+
+    struct ActorInitializer
+    {
+        Actor operator()() const { return Actor(); }
+    };
+
+    struct ThrowsOnNegative
+    {
+        int value;
+
+        explicit ThrowsOnNegative(int v) : value(v)
+        {
+            if (v < 0)
+            {
+                throw std::runtime_error("negative");
+            }
+        }
+    };
+
+    /// acquire when the coin says so (or nothing is live), otherwise release a random live object; the same sequence for every pool
+    std::vector<std::uint32_t> churnSequence(std::size_t length)
+    {
+        std::mt19937 rng(11);
+        std::vector<std::uint32_t> sequence(length);
+        for (std::uint32_t& r : sequence) r = rng();
+        return sequence;
+    }
+
+    void checkSlabPool()
+    {
+        SlabObjectPool<Actor, 16> pool;
+        std::vector<std::pair<Actor*, int>> live;
+        std::mt19937 rng(1);
+
+        for (int i = 0; i < 20000; ++i)
+        {
+            if (live.empty() || rng() % 2)
+            {
+                Actor* a = pool.acquire(i);
+                CHECK(reinterpret_cast<std::uintptr_t>(a) % alignof(Actor) == 0);
+                live.emplace_back(a, i);
+            }
+            else
+            {
+                const std::size_t k = rng() % live.size();
+                pool.release(live[k].first);
+                live[k] = live.back();
+                live.pop_back();
+            }
+        }
+
+        // nothing moved: every pointer still holds the object built into it
+        for (const auto& [actor, id] : live)
+        {
+            CHECK(actor->transform[0] == float(id) && actor->name == "actor " + std::to_string(id));
+        }
+
+        CHECK(pool.size() == live.size() && pool.capacity() >= live.size() && pool.capacity() % 16 == 0);
+
+        for (const auto& entry : live)
+        {
+            pool.release(entry.first);
+        }
+
+        CHECK(pool.size() == 0);
+
+        SlabObjectPool<int> reserved(1000);
+        CHECK(reserved.capacity() >= 1000);
+
+        // a throwing constructor neither leaks the slot nor breaks the free list
+        SlabObjectPool<ThrowsOnNegative, 4> throwing;
+        ThrowsOnNegative* first = throwing.acquire(1);
+        bool threw = false;
+
+        try
+        {
+            throwing.acquire(-1);
+        }
+        catch (const std::runtime_error&)
+        {
+            threw = true;
+        }
+
+        CHECK(threw && throwing.size() == 1);
+        ThrowsOnNegative* rest[3] = { throwing.acquire(2), throwing.acquire(3), throwing.acquire(4) };
+        CHECK(throwing.capacity() == 4);
+        CHECK(rest[0] != first && rest[1] != first && rest[2] != first && rest[0] != rest[1] && rest[1] != rest[2] && rest[0] != rest[2]);
+        CHECK(rest[0]->value + rest[1]->value + rest[2]->value == 9);
+
+        throwing.release(first);
+        for (ThrowsOnNegative* p : rest) throwing.release(p);
+    }
+
+    void benchmark(int repeats)
+    {
+        constexpr std::size_t operations = 100000;
+        constexpr std::size_t fixedPoolSize = 4096;
+        const std::vector<std::uint32_t> sequence = churnSequence(operations);
+        std::size_t sink = 0;
+
+        // the moving pools hand out objects by value, so live objects sit in a vector of their own
+        const double slabMs = bestTimeMs(3 * repeats, [&]
+        {
+            SlabObjectPool<Actor, 256> pool(fixedPoolSize);
+            std::vector<Actor*> live;
+            live.reserve(fixedPoolSize);
+
+            for (std::uint32_t r : sequence)
+            {
+                if ((live.empty() || r % 2) && live.size() < fixedPoolSize)
+                {
+                    live.push_back(pool.acquire(int(r % 1000)));
+                }
+                else
+                {
+                    Actor*& a = live[r % live.size()];
+                    sink += a->name.size();
+                    pool.release(a);
+                    a = live.back();
+                    live.pop_back();
+                }
+            }
+
+            for (Actor* a : live) pool.release(a);
+        });
+
+        const double dynamicMs = bestTimeMs(3 * repeats, [&]
+        {
+            ObjectPoolDynamic<Actor, ActorInitializer, 256> pool{ ActorInitializer{}, int(fixedPoolSize) };
+            std::vector<Actor> live;
+            live.reserve(fixedPoolSize);
+
+            for (std::uint32_t r : sequence)
+            {
+                if ((live.empty() || r % 2) && live.size() < fixedPoolSize)
+                {
+                    live.emplace_back();
+                    pool.acquire(live.back());
+                    live.back().name = "actor " + std::to_string(r % 1000);
+                }
+                else
+                {
+                    Actor& a = live[r % live.size()];
+                    sink += a.name.size();
+                    pool.release(std::move(a));
+                    a = std::move(live.back());
+                    live.pop_back();
+                }
+            }
+
+            for (Actor& a : live) pool.release(std::move(a));
+        });
+
+        auto fixedPool = std::make_unique<ObjectPool<Actor, fixedPoolSize>>();
+
+        const double fixedMs = bestTimeMs(3 * repeats, [&]
+        {
+            std::vector<Actor> live;
+            live.reserve(fixedPoolSize);
+
+            for (std::uint32_t r : sequence)
+            {
+                if ((live.empty() || r % 2) && live.size() < fixedPoolSize)
+                {
+                    live.emplace_back();
+                    CHECK(fixedPool->acquire(live.back()));
+                    live.back().name = "actor " + std::to_string(r % 1000);
+                }
+                else
+                {
+                    Actor& a = live[r % live.size()];
+                    sink += a.name.size();
+                    fixedPool->release(std::move(a));
+                    a = std::move(live.back());
+                    live.pop_back();
+                }
+            }
+
+            for (Actor& a : live) fixedPool->release(std::move(a));
+        });
+
+        CHECK(sink > 0);
+
+        std::printf("%zu acquire / release operations on a %zu byte object\n", operations, sizeof(Actor));
+        report("SlabObjectPool", slabMs, operations);
+        report("ObjectPoolDynamic", dynamicMs, operations);
+        report("ObjectPool", fixedMs, operations);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    checkSlabPool();
+    benchmark(repeatFactor(argc, argv));
+    return 0;
+}
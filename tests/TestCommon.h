@@ -0,0 +1,89 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <span>
+
+#include "GridGraph.h"
+
+/// fails the test with the location and expression; active in every build type, unlike assert
+#define CHECK(expr)                                                                          \
+    do                                                                                       \
+    {                                                                                        \
+        if (!(expr))                                                                         \
+        {                                                                                    \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #expr);  \
+            std::exit(1);                                                                    \
+        }                                                                                    \
+    } while (0)
+
+namespace GameFoundationTests
+{
+    using namespace Virtuoso::GameFoundations;
+
+    /// repeat factor for benchmarks: the first command line argument, 1 when missing. Keeps the ctest run short
+    inline int repeatFactor(int argc, char** argv)
+    {
+        const int factor = argc > 1 ? std::atoi(argv[1]) : 1;
+        return factor > 0 ? factor : 1;
+    }
+
+    /// best wall clock time of fn over repeats runs, in milliseconds
+    template <typename Fn>
+    double bestTimeMs(int repeats, Fn&& fn)
+    {
+        double best = 0.0;
+
+        for (int i = 0; i < repeats; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            fn();
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            best = (i == 0 || ms < best) ? ms : best;
+        }
+
+        return best;
+    }
+
+    /// one benchmark line: total time and time per operation
+    inline void report(const char* name, double ms, std::size_t operations)
+    {
+        std::printf("%-48s %10.3f ms %10.1f ns/op\n", name, ms, operations ? ms * 1e6 / double(operations) : 0.0);
+    }
+
+    /// width x height grid with about wallPercent of its cells blocked, the same for a given seed
+    inline GridGraph randomGrid(std::uint32_t width, std::uint32_t height, int wallPercent, unsigned seed)
+    {
+        GridGraph grid(width, height);
+        std::mt19937 rng(seed);
+
+        for (std::uint32_t y = 0; y < height; ++y)
+        {
+            for (std::uint32_t x = 0; x < width; ++x)
+            {
+                if (int(rng() % 100) < wallPercent)
+                {
+                    grid.set_walkable(int(x), int(y), false);
+                }
+            }
+        }
+
+        return grid;
+    }
+
+    /// sum of cost over consecutive nodes of path
+    template <typename Graph, typename CostFn>
+    double pathCost(const Graph& graph, std::span<const typename Graph::NodeHandle> path, CostFn cost)
+    {
+        double total = 0.0;
+
+        for (std::size_t i = 1; i < path.size(); ++i)
+        {
+            total += cost(graph, path[i - 1], path[i]);
+        }
+
+        return total;
+    }
+}
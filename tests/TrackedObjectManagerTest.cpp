@@ -0,0 +1,161 @@
+// TrackedObjectManager change log: inserts, modifications and removes show up in changesSince() with the frame they happened in,
+// a slot is logged as Modified at most once per frame, and discardChangesUpTo() drops exactly the frames it is given
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TestCommon.h"
+#include "TrackedObjectManager.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    using Manager = TrackedObjectManager<std::string>;
+    using Change = Manager::Change;
+
+    bool sameChange(const Change& c, const ObjectHandle& handle, std::uint64_t frame, ObjectChangeKind kind)
+    {
+        return c.handle == handle && c.frame == frame && c.kind == kind;
+    }
+
+    void handWrittenFrames()
+    {
+        Manager manager;
+        CHECK(manager.frame() == 1 && manager.changesSince(0).empty());
+
+        // frame 1: two inserts; modifying a fresh object adds nothing
+        const ObjectHandle a = manager.insertObject("a");
+        const ObjectHandle b = manager.insertObject("b");
+        *manager.modifyObject(a) += "1";
+
+        CHECK(manager.changesSince(0).size() == 2);
+        CHECK(sameChange(manager.changesSince(0)[0], a, 1, ObjectChangeKind::Inserted));
+        CHECK(sameChange(manager.changesSince(0)[1], b, 1, ObjectChangeKind::Inserted));
+
+        // frame 2: a modified twice (logged once), b removed, a stale handle neither modified nor removed
+        CHECK(manager.advanceFrame() == 2);
+        *manager.modifyObject(a) += "2";
+        *manager.modifyObject(a) += "3";
+        CHECK(manager.removeObject(b));
+        CHECK(!manager.removeObject(b) && manager.modifyObject(b) == nullptr);
+        CHECK(*manager.lookupObject(a) == "a123");
+
+        std::span<const Change> frame2 = manager.changesSince(1);
+        CHECK(frame2.size() == 2);
+        CHECK(sameChange(frame2[0], a, 2, ObjectChangeKind::Modified));
+        CHECK(sameChange(frame2[1], b, 2, ObjectChangeKind::Removed));
+
+        // frame 3: b's slot is reused; the new object is an insert under a new handle, then modified in a later frame
+        manager.advanceFrame();
+        const ObjectHandle c = manager.insertObject("c");
+        CHECK(c.index == b.index && c != b);
+        *manager.modifyObject(c) += "!";
+        manager.advanceFrame();
+        manager.modifyObject(c);
+
+        std::span<const Change> recent = manager.changesSince(2);
+        CHECK(recent.size() == 2);
+        CHECK(sameChange(recent[0], c, 3, ObjectChangeKind::Inserted));
+        CHECK(sameChange(recent[1], c, 4, ObjectChangeKind::Modified));
+        CHECK(manager.changesSince(4).empty());
+
+        // untracked writes and reads aren't logged
+        *manager.untracked().lookupObject(a) = "quiet";
+        manager.lookupObject(a);
+        CHECK(manager.changesSince(3).size() == 1);
+
+        // discarding up to frame 2 keeps frames 3 and 4, wherever the consumer asks from
+        manager.discardChangesUpTo(2);
+        CHECK(manager.changesSince(0).size() == 2 && manager.changesSince(0)[0].frame == 3);
+        manager.discardChangesUpTo(10);
+        CHECK(manager.changesSince(0).empty() && manager.size() == 2);
+    }
+
+    /// random frames checked against a model of what each consumer should see
+    void randomFrames()
+    {
+        Manager manager;
+        std::mt19937 rng(4);
+        std::map<std::uint32_t, ObjectHandle> live;   ///< by handle value, so picks are deterministic
+        std::vector<Change> expected;
+        std::map<std::uint32_t, std::uint64_t> modifiedIn;
+        std::uint64_t discarded = 0;
+
+        for (int frame = 0; frame < 200; ++frame)
+        {
+            for (int op = 0; op < 20; ++op)
+            {
+                const unsigned r = rng() % 3;
+
+                if (r == 0 || live.empty())
+                {
+                    const ObjectHandle h = manager.insertObject(std::to_string(rng()));
+                    live.emplace(h.value, h);
+                    expected.push_back({ h, manager.frame(), ObjectChangeKind::Inserted });
+                    modifiedIn[h.index] = manager.frame();
+                }
+                else
+                {
+                    auto it = live.begin();
+                    std::advance(it, rng() % live.size());
+                    const ObjectHandle h = it->second;
+
+                    if (r == 1)
+                    {
+                        CHECK(manager.modifyObject(h) != nullptr);
+
+                        if (modifiedIn[h.index] != manager.frame())
+                        {
+                            modifiedIn[h.index] = manager.frame();
+                            expected.push_back({ h, manager.frame(), ObjectChangeKind::Modified });
+                        }
+                    }
+                    else
+                    {
+                        CHECK(manager.removeObject(h));
+                        live.erase(it);
+                        expected.push_back({ h, manager.frame(), ObjectChangeKind::Removed });
+                    }
+                }
+            }
+
+            // a consumer a few frames behind sees exactly the changes after its frame
+            const std::uint64_t seen = manager.frame() > 3 ? manager.frame() - 3 : 0;
+            const std::span<const Change> changes = manager.changesSince(seen);
+            std::size_t k = 0;
+
+            for (const Change& e : expected)
+            {
+                if (e.frame > seen && e.frame > discarded)
+                {
+                    CHECK(k < changes.size() && sameChange(changes[k], e.handle, e.frame, e.kind));
+                    ++k;
+                }
+            }
+
+            CHECK(k == changes.size());
+
+            if (frame % 10 == 9)
+            {
+                discarded = manager.frame() - 5;
+                manager.discardChangesUpTo(discarded);
+                CHECK(manager.changesSince(0).empty() || manager.changesSince(0)[0].frame > discarded);
+            }
+
+            manager.advanceFrame();
+        }
+
+        CHECK(manager.size() == live.size());
+    }
+}
+
+int main()
+{
+    handWrittenFrames();
+    randomFrames();
+    std::printf("ok\n");
+    return 0;
+}
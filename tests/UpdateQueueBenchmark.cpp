@@ -0,0 +1,141 @@
+// PooledUpdateQueue against UpdateQueue: both run every event once, earliest first, and schedule-plus-dispatch throughput and
+// heap allocations per event are measured for a capture too big for std::function's small buffer
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "CountingAllocator.h"
+#include "TestCommon.h"
+#include "UpdateQueue.h"
+
+using namespace GameFoundationTests;
+
+namespace
+{
+    /// what the events do: check they run in timestamp order and not before they're due, and add up their damage
+    struct Recorder
+    {
+        double now = 0.0;
+        double lastTimestamp = 0.0;
+        double damage = 0.0;
+        std::size_t ran = 0;
+
+        void record(double timestamp, double amount, std::uint32_t target)
+        {
+            CHECK(timestamp <= now && timestamp >= lastTimestamp);
+            lastTimestamp = timestamp;
+            damage += amount * double(target % 7 + 1);
+            ++ran;
+        }
+    };
+
+    constexpr int frames = 200;
+    constexpr int eventsPerFrame = 500;
+    constexpr std::size_t eventCount = std::size_t(frames) * eventsPerFrame;
+
+    /// each frame schedules eventsPerFrame events due within the next two frames, then dispatches what is due
+    template <typename Queue, typename Schedule>
+    void simulate(Queue& queue, Recorder& recorder, Schedule&& schedule)
+    {
+        std::mt19937 rng(3);
+
+        for (int frame = 0; frame < frames; ++frame)
+        {
+            for (int i = 0; i < eventsPerFrame; ++i)
+            {
+                const double timestamp = frame + double(rng() % 2000) / 1000.0;
+                const double amount = double(rng() % 100);
+                const std::uint32_t target = rng();
+                Recorder* r = &recorder;
+
+                // 32 bytes of capture: more than std::function holds inline
+                schedule(queue, timestamp, [r, timestamp, amount, target] { r->record(timestamp, amount, target); });
+            }
+
+            recorder.now = double(frame);
+            processUpdateEvents(recorder.now, queue);
+        }
+
+        recorder.now = double(frames + 2);
+        processUpdateEvents(recorder.now, queue);
+        CHECK(queue.empty());
+    }
+
+    struct Result
+    {
+        double ms;
+        double allocationsPerEvent;
+        double damage;
+    };
+
+    template <typename Queue, typename Schedule>
+    Result measure(Queue& queue, int repeats, Schedule schedule)
+    {
+        // a first run grows the queue's storage to its peak; the timed runs are the steady state
+        Recorder warmup;
+        simulate(queue, warmup, schedule);
+        CHECK(warmup.ran == eventCount);
+
+        const std::size_t before = allocations();
+        Recorder recorder;
+
+        const double ms = bestTimeMs(repeats, [&]
+        {
+            recorder = Recorder();
+            simulate(queue, recorder, schedule);
+        });
+
+        const double perEvent = double(allocations() - before) / double(eventCount * std::size_t(repeats));
+        CHECK(recorder.ran == eventCount && recorder.damage == warmup.damage);
+        return { ms, perEvent, recorder.damage };
+    }
+
+    /// events scheduled by events, and equal timestamps, run in the order they were scheduled
+    void checkPooledOrdering()
+    {
+        PooledUpdateQueue<> queue(64);
+        std::vector<int> order;
+        order.reserve(16);
+
+        queue.schedule(1.0, [&] { order.push_back(0); queue.schedule(1.0, [&] { order.push_back(3); }); });
+        queue.schedule(1.0, [&] { order.push_back(1); });
+        queue.schedule(0.5, [&] { order.push_back(-1); });
+        queue.schedule(1.0, [&] { order.push_back(2); });
+        queue.schedule(4.0, [&] { order.push_back(9); });
+
+        CHECK(queue.process(1.0) == 5);
+        CHECK((order == std::vector<int>{ -1, 0, 1, 2, 3 }));
+        CHECK(queue.size() == 1 && queue.nextTimestamp() == 4.0);
+
+        queue.clear();
+        CHECK(queue.empty() && queue.process(10.0) == 0 && order.size() == 5);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    checkPooledOrdering();
+
+    const int repeats = 3 * repeatFactor(argc, argv);
+
+    UpdateQueue queue;
+    const Result plain = measure(queue, repeats, [](UpdateQueue& q, double timestamp, auto&& f)
+    {
+        q.push(UpdateEvent{ timestamp, f });
+    });
+
+    PooledUpdateQueue<> pooled(eventsPerFrame * 3);
+    const Result pool = measure(pooled, repeats, [](PooledUpdateQueue<>& q, double timestamp, auto&& f)
+    {
+        q.schedule(timestamp, f);
+    });
+
+    CHECK(plain.damage == pool.damage);
+    CHECK(pool.allocationsPerEvent == 0.0);
+
+    std::printf("%d frames of %d events, dispatched as they fall due\n", frames, eventsPerFrame);
+    report("UpdateQueue, schedule + dispatch", plain.ms, eventCount);
+    report("PooledUpdateQueue, schedule + dispatch", pool.ms, eventCount);
+    std::printf("heap allocations per event: UpdateQueue %.2f, PooledUpdateQueue %.2f\n", plain.allocationsPerEvent, pool.allocationsPerEvent);
+    return 0;
+}